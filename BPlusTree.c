@@ -3,6 +3,13 @@
 #include <string.h>
 #include "BPlusTree.h"
 #include "fila.h" 
+#include "bloom.h"
+#include "hibrido.h"
+#include "indice_hash.h"
+#if REGISTRO_COMPACTO
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
 
 // Estruturas Auxiliares
 typedef struct {
@@ -11,6 +18,17 @@ typedef struct {
     int ocorreuSplit;
 } SplitResult;
 
+#define TAM_BUFFER_LOTE 256 //entradas que a folha mescla sem alocar memória
+#define CAPACIDADE_MINIMA_FILTRO 1024 //chaves previstas no menor filtro de Bloom
+
+// Chaves e nós novos que um nível devolve ao pai durante a inserção em lote
+typedef struct {
+    unsigned long long *chaves;
+    nodo_t **nodos;
+    int quantidade;
+    int capacidade;
+} Promovidos;
+
 
 // Protótipos de Funções Estáticas/Auxiliares
 static int _obterIndiceChave(nodo_t *nodo, unsigned long long chave);
@@ -20,13 +38,217 @@ static void _imprimeNodo(nodo_t *nodo); // Usado por imprimeArvore
 static SplitResult _inserirRecursivo(nodo_t *current_node, registro_t *registro, BPlusTree_t *arvore);
 static void _dividirNodoFolha(nodo_t *nodoCheio, unsigned long long chaveNova, registro_t *registroNovo, SplitResult *result);
 static void _dividirNodoInterno(nodo_t *nodoCheio, unsigned long long chavePromovidaFilho, nodo_t *filhoDireitoPromovido, SplitResult *result);
+static nodo_t *_clonarNodo(nodo_t *nodo);
+static void _copiarCaminho(BPlusTree_t *arvore, unsigned long long chave);
+static void _liberarVersao(BPlusTree_t *arvore, nodo_t *nodo);
+static void _inserirLoteRecursivo(BPlusTree_t *arvore, nodo_t *nodo, registro_t **registros, int numRegistros, Promovidos *saida);
+static void _verificarCapacidadeFiltro(BPlusTree_t *arvore);
+static void _registrarFolhaHibrido(BPlusTree_t *arvore, unsigned long long limite, nodo_t *folha);
+static void _indexarSubarvore(IndiceHibrido_t *indice, nodo_t *nodo, unsigned long long limite);
+static void _reconstruirHibrido(BPlusTree_t *arvore);
+static nodo_t *_primeiraFolha(nodo_t *raiz);
+static SplitResult _inserirFilho(BPlusTree_t *arvore, nodo_t *nodo, unsigned long long chave, nodo_t *filhoDireito);
+static void _crescerRaiz(BPlusTree_t *arvore, Promovidos *promovidos);
+#if ESTATISTICAS_ORDEM
+static long _totalSubarvore(nodo_t *nodo);
+static void _recalcularContagens(nodo_t *nodo);
+#endif
 void gerarDotConteudoHTML(nodo_t *nodo, FILE *f); // Usado por gerarDot
+static void _gerarDotNodo(nodo_t *nodo, FILE *f); // Usado por gerarDotConteudoHTML
 
 
 // ====================================================================================
 // Funções de Manipulação de Registro
 // ====================================================================================
 
+#if REGISTRO_COMPACTO
+
+#define REGISTROS_POR_BLOCO 4096
+#define TAM_NOME_DICIONARIO 20
+
+// Dicionário de nomes; o código de um nome é sua posição no vetor. Um nome escrito
+// nunca muda e só é publicado (tamanho, com release) depois de copiado, então as
+// consultas não precisam de trava; só acrescentar nomes é serializado.
+typedef struct {
+    char nomes[MAX_DICIONARIO][TAM_NOME_DICIONARIO];
+    atomic_int tamanho;
+} Dicionario_t;
+
+// Registros livres reaproveitam a própria memória para formar a lista
+typedef union RegistroLivre {
+    registro_t registro;
+    union RegistroLivre *proximo;
+} RegistroLivre;
+
+// Os registros são alocados em blocos contíguos, sem cabeçalho do malloc por registro
+typedef struct BlocoRegistros {
+    struct BlocoRegistros *anterior;
+    RegistroLivre registros[REGISTROS_POR_BLOCO];
+} BlocoRegistros;
+
+static Dicionario_t dicionarioModelos;
+static Dicionario_t dicionarioCores;
+static pthread_mutex_t travaDicionarios = PTHREAD_MUTEX_INITIALIZER; // só para acrescentar nomes
+// Todos os blocos, de todas as threads; a trava só é tomada a cada REGISTROS_POR_BLOCO registros
+static BlocoRegistros *blocos = NULL;
+static pthread_mutex_t travaBlocos = PTHREAD_MUTEX_INITIALIZER;
+static atomic_uint geracaoPool; // incrementada por liberarPoolRegistros
+
+// Cada thread tem o seu bloco em uso e a sua lista de livres (particionada.c cria e
+// destrói registros em várias threads); no caminho comum não há trava. Um registro
+// destruído por outra thread entra na lista dela.
+static _Thread_local BlocoRegistros *blocoAtual = NULL;
+static _Thread_local int usadosNoBloco = REGISTROS_POR_BLOCO;
+static _Thread_local RegistroLivre *registrosLivres = NULL;
+static _Thread_local unsigned int geracaoLocal = 0;
+
+// Descarta o cache da thread se o pool foi liberado desde o último uso
+static void _sincronizarPool(void) {
+    unsigned int geracao = atomic_load_explicit(&geracaoPool, memory_order_relaxed);
+    if (geracaoLocal != geracao) {
+        blocoAtual = NULL;
+        usadosNoBloco = REGISTROS_POR_BLOCO;
+        registrosLivres = NULL;
+        geracaoLocal = geracao;
+    }
+}
+
+static int _procurarNoDicionario(Dicionario_t *dicionario, const char *nome) {
+    int tamanho = atomic_load_explicit(&dicionario->tamanho, memory_order_acquire);
+    for (int i = 0; i < tamanho; i++) {
+        if (strncmp(dicionario->nomes[i], nome, TAM_NOME_DICIONARIO - 1) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Retorna o código do nome, acrescentando-o ao dicionário se for novo (-1 se estiver cheio)
+static int _internar(Dicionario_t *dicionario, const char *nome) {
+    int codigo = _procurarNoDicionario(dicionario, nome);
+    if (codigo >= 0) {
+        return codigo;
+    }
+    pthread_mutex_lock(&travaDicionarios);
+    codigo = _procurarNoDicionario(dicionario, nome); // outra thread pode tê-lo acrescentado
+    int tamanho = atomic_load_explicit(&dicionario->tamanho, memory_order_relaxed);
+    if (codigo < 0 && tamanho < MAX_DICIONARIO) {
+        strncpy(dicionario->nomes[tamanho], nome, TAM_NOME_DICIONARIO - 1);
+        dicionario->nomes[tamanho][TAM_NOME_DICIONARIO - 1] = '\0';
+        atomic_store_explicit(&dicionario->tamanho, tamanho + 1, memory_order_release);
+        codigo = tamanho;
+    }
+    pthread_mutex_unlock(&travaDicionarios);
+    return codigo;
+}
+
+// Codifica os campos no formato compacto; entradas que não cabem rejeitam só este registro (0)
+static int _codificar(registro_t *destino, unsigned long long chave, const char *modelo, int ano, const char *cor) {
+    if (ano < ANO_BASE || ano > ANO_BASE + 255) {
+        fprintf(stderr, "Erro: ano %d fora do intervalo do registro compacto (%d-%d). Registro %llu rejeitado.\n", ano, ANO_BASE, ANO_BASE + 255, chave);
+        return 0;
+    }
+    int codigoModelo = _internar(&dicionarioModelos, modelo);
+    int codigoCor = _internar(&dicionarioCores, cor);
+    if (codigoModelo < 0 || codigoCor < 0) {
+        fprintf(stderr, "Erro: dicionário do registro compacto cheio (%d nomes). Registro %llu rejeitado.\n", MAX_DICIONARIO, chave);
+        return 0;
+    }
+    destino->chave = chave;
+    destino->modelo = (unsigned char)codigoModelo;
+    destino->cor = (unsigned char)codigoCor;
+    destino->ano = (unsigned char)(ano - ANO_BASE);
+    return 1;
+}
+
+registro_t *criarRegistro(unsigned long long chave, const char *modelo, int ano, const char *cor) {
+    registro_t codificado;
+    if (!_codificar(&codificado, chave, modelo, ano, cor)) {
+        return NULL;
+    }
+
+    _sincronizarPool();
+    registro_t *novoRegistro;
+    if (registrosLivres != NULL) {
+        novoRegistro = &registrosLivres->registro;
+        registrosLivres = registrosLivres->proximo;
+    } else {
+        if (usadosNoBloco == REGISTROS_POR_BLOCO) {
+            BlocoRegistros *bloco = (BlocoRegistros *)malloc(sizeof(BlocoRegistros));
+            if (bloco == NULL) {
+                perror("Erro ao alocar registro");
+                exit(EXIT_FAILURE);
+            }
+            pthread_mutex_lock(&travaBlocos);
+            bloco->anterior = blocos;
+            blocos = bloco;
+            pthread_mutex_unlock(&travaBlocos);
+            blocoAtual = bloco;
+            usadosNoBloco = 0;
+        }
+        novoRegistro = &blocoAtual->registros[usadosNoBloco++].registro;
+    }
+    *novoRegistro = codificado;
+    return novoRegistro;
+}
+
+int atualizarRegistro(registro_t *registro, const char *modelo, int ano, const char *cor) {
+    return _codificar(registro, registro->chave, modelo, ano, cor);
+}
+
+void destruirRegistro(registro_t *registro) {
+    if (registro) {
+        _sincronizarPool();
+        RegistroLivre *livre = (RegistroLivre *)registro;
+        livre->proximo = registrosLivres;
+        registrosLivres = livre;
+    }
+}
+
+int codigoModelo(const char *modelo) {
+    return _procurarNoDicionario(&dicionarioModelos, modelo);
+}
+
+int codigoCor(const char *cor) {
+    return _procurarNoDicionario(&dicionarioCores, cor);
+}
+
+// As outras threads descartam o próprio cache na próxima criação ou destruição
+void liberarPoolRegistros(void) {
+    pthread_mutex_lock(&travaBlocos);
+    while (blocos != NULL) {
+        BlocoRegistros *anterior = blocos->anterior;
+        free(blocos);
+        blocos = anterior;
+    }
+    atomic_fetch_add_explicit(&geracaoPool, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&travaBlocos);
+    _sincronizarPool();
+}
+
+const char *registroModelo(const registro_t *registro) {
+    return dicionarioModelos.nomes[registro->modelo];
+}
+
+const char *registroCor(const registro_t *registro) {
+    return dicionarioCores.nomes[registro->cor];
+}
+
+int registroAno(const registro_t *registro) {
+    return ANO_BASE + registro->ano;
+}
+
+int definirRegistroAno(registro_t *registro, int ano) {
+    if (ano < ANO_BASE || ano > ANO_BASE + 255) {
+        fprintf(stderr, "Erro: ano %d fora do intervalo do registro compacto (%d-%d). Registro %llu mantido.\n", ano, ANO_BASE, ANO_BASE + 255, registro->chave);
+        return 0;
+    }
+    registro->ano = (unsigned char)(ano - ANO_BASE);
+    return 1;
+}
+
+#else
+
 registro_t *criarRegistro(unsigned long long chave, const char *modelo, int ano, const char *cor) {
     registro_t *novoRegistro = (registro_t *)malloc(sizeof(registro_t));
     if (novoRegistro == NULL) {
@@ -42,12 +264,40 @@ registro_t *criarRegistro(unsigned long long chave, const char *modelo, int ano,
     return novoRegistro;
 }
 
+int atualizarRegistro(registro_t *registro, const char *modelo, int ano, const char *cor) {
+    strncpy(registro->modelo, modelo, TAM_MODELO - 1);
+    registro->modelo[TAM_MODELO - 1] = '\0';
+    registro->ano = ano;
+    strncpy(registro->cor, cor, TAM_COR - 1);
+    registro->cor[TAM_COR - 1] = '\0';
+    return 1;
+}
+
 void destruirRegistro(registro_t *registro) {
     if (registro) {
         free(registro);
     }
 }
 
+const char *registroModelo(const registro_t *registro) {
+    return registro->modelo;
+}
+
+const char *registroCor(const registro_t *registro) {
+    return registro->cor;
+}
+
+int registroAno(const registro_t *registro) {
+    return registro->ano;
+}
+
+int definirRegistroAno(registro_t *registro, int ano) {
+    registro->ano = ano;
+    return 1;
+}
+
+#endif // REGISTRO_COMPACTO
+
 // ====================================================================================
 // Funções de Manipulação de Nó
 // ====================================================================================
@@ -60,9 +310,13 @@ nodo_t *criarNodo(int folha) {
     }
     novoNodo->numChaves = 0;
     novoNodo->folha = folha;
+    novoNodo->referencias = 1;
     novoNodo->proximo = NULL; // Usado apenas para nós folha
     for (int i = 0; i < ORDEM; i++) {
         novoNodo->filhos[i] = NULL;
+#if ESTATISTICAS_ORDEM
+        novoNodo->contagens[i] = 0;
+#endif
     }
     for (int i = 0; i < ORDEM - 1; i++) {
         novoNodo->registros[i] = NULL;
@@ -95,19 +349,24 @@ BPlusTree_t *criarArvoreBPlus() {
     }
     arvore->raiz = criarNodo(1); // A raiz é inicialmente uma folha
     arvore->numNodos = 1;
+    arvore->nodosDesatualizados = 0;
+    arvore->numSnapshots = 0;
+    arvore->nodosVersoes = 0;
+    arvore->filtro = NULL;
+    arvore->hibrido = NULL;
+    arvore->hash = NULL;
     return arvore;
 }
 
+// Em pós-ordem o percurso não volta a um nó depois de entregá-lo, então ele pode ser liberado na hora
 void destruirArvoreBPlus(nodo_t *raiz) {
-    if (raiz == NULL) {
-        return;
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, raiz, PERCURSO_POS_ORDEM);
+    nodo_t *nodo;
+    while ((nodo = proximoNodo(&percurso, NULL)) != NULL) {
+        destruirNodo(nodo);
     }
-    if (!raiz->folha) {
-        for (int i = 0; i <= raiz->numChaves; i++) {
-            destruirArvoreBPlus(raiz->filhos[i]);
-        }
-    }
-    destruirNodo(raiz);
+    encerrarPercurso(&percurso);
 }
 
 
@@ -143,12 +402,17 @@ static nodo_t *_buscarFolha(nodo_t *raiz, unsigned long long chave) {
     return atual;
 }
 
-// Função para buscar um registro na árvore B+ (apenas em nós folhas)
-registro_t *buscar(BPlusTree_t *arvore, unsigned long long chave) {
-    if (arvore == NULL || arvore->raiz == NULL) {
-        return NULL;
+// Folha onde a chave está ou estaria: pela ART quando o índice híbrido está em dia,
+// senão descendo pelos nós internos
+static nodo_t *_localizarFolha(BPlusTree_t *arvore, unsigned long long chave) {
+    if (arvore->hibrido != NULL && arvore->hibrido->valido) {
+        return rotearIndiceHibrido(arvore->hibrido, chave);
     }
-    nodo_t *folha = _buscarFolha(arvore->raiz, chave);
+    return _buscarFolha(arvore->raiz, chave);
+}
+
+// Procura a chave dentro de uma folha
+static registro_t *_buscarNaFolha(nodo_t *folha, unsigned long long chave) {
     for (int i = 0; i < folha->numChaves; i++) {
         if (folha->chaves[i] == chave) {
             return folha->registros[i];
@@ -157,6 +421,45 @@ registro_t *buscar(BPlusTree_t *arvore, unsigned long long chave) {
     return NULL;
 }
 
+// Busca a chave na subárvore com a raiz informada
+static registro_t *_buscarRegistro(nodo_t *raiz, unsigned long long chave) {
+    return _buscarNaFolha(_buscarFolha(raiz, chave), chave);
+}
+
+// Função para buscar um registro na árvore B+ (apenas em nós folhas)
+registro_t *buscar(BPlusTree_t *arvore, unsigned long long chave) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return NULL;
+    }
+    // A tabela tem todas as chaves: a resposta dela é definitiva, sem descer a árvore
+    if (arvore->hash != NULL) {
+        return buscarIndiceHash(arvore->hash, chave);
+    }
+    // O filtro descarta a maioria das chaves ausentes sem descer a árvore
+    if (arvore->filtro != NULL && !consultarFiltroBloom(arvore->filtro, chave)) {
+        return NULL;
+    }
+    return _buscarNaFolha(_localizarFolha(arvore, chave), chave);
+}
+
+// Varredura de intervalo: desce até a folha de 'inicio' e segue o encadeamento
+void percorrerIntervalo(BPlusTree_t *arvore, unsigned long long inicio, unsigned long long fim, int (*visitar)(registro_t *registro, void *contexto), void *contexto) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return;
+    }
+    nodo_t *folha = _localizarFolha(arvore, inicio);
+    int i = _obterIndiceChave(folha, inicio);
+    while (folha != NULL) {
+        for (; i < folha->numChaves; i++) {
+            if (folha->chaves[i] > fim || !visitar(folha->registros[i], contexto)) {
+                return;
+            }
+        }
+        folha = folha->proximo;
+        i = 0;
+    }
+}
+
 
 // ====================================================================================
 // Funções Auxiliares de Inserção
@@ -288,6 +591,33 @@ static void _dividirNodoInterno(nodo_t *nodoCheio, unsigned long long chavePromo
     }
 }
 
+// Insere a chave promovida e o filho à direita dela em um nó interno, dividindo-o se estiver cheio
+static SplitResult _inserirFilho(BPlusTree_t *arvore, nodo_t *nodo, unsigned long long chave, nodo_t *filhoDireito) {
+    SplitResult result = {0, NULL, 0};
+    if (nodo->numChaves < ORDEM - 1) {
+        int i = nodo->numChaves - 1;
+        while (i >= 0 && chave < nodo->chaves[i]) {
+            nodo->chaves[i + 1] = nodo->chaves[i];
+            nodo->filhos[i + 2] = nodo->filhos[i + 1];
+            i--;
+        }
+        nodo->chaves[i + 1] = chave;
+        nodo->filhos[i + 2] = filhoDireito;
+        nodo->numChaves++;
+    } else {
+        _dividirNodoInterno(nodo, chave, filhoDireito, &result);
+        arvore->numNodos++;
+    }
+#if ESTATISTICAS_ORDEM
+    // Os filhos mudaram de posição; recontar custa O(ORDEM²), mas só ocorre em divisões
+    _recalcularContagens(nodo);
+    if (result.ocorreuSplit) {
+        _recalcularContagens(result.novoNodo);
+    }
+#endif
+    return result;
+}
+
 // Função recursiva principal para inserção que retorna um SplitResult
 static SplitResult _inserirRecursivo(nodo_t *current_node, registro_t *registro, BPlusTree_t *arvore) {
     SplitResult result = {0, NULL, 0}; // Inicializa com sem split
@@ -298,27 +628,18 @@ static SplitResult _inserirRecursivo(nodo_t *current_node, registro_t *registro,
         } else {
             _dividirNodoFolha(current_node, registro->chave, registro, &result);
             arvore->numNodos++;
+            _registrarFolhaHibrido(arvore, result.chave, result.novoNodo);
         }
     } else { // Nó interno
         int child_index = _obterIndiceChave(current_node, registro->chave);
 
         SplitResult child_split_result = _inserirRecursivo(current_node->filhos[child_index], registro, arvore);
+#if ESTATISTICAS_ORDEM
+        current_node->contagens[child_index]++; // a duplicata já foi descartada em inserir()
+#endif
 
         if (child_split_result.ocorreuSplit) {
-            if (current_node->numChaves < ORDEM - 1) {
-                int i = current_node->numChaves - 1;
-                while (i >= 0 && child_split_result.chave < current_node->chaves[i]) {
-                    current_node->chaves[i + 1] = current_node->chaves[i];
-                    current_node->filhos[i + 2] = current_node->filhos[i + 1];
-                    i--;
-                }
-                current_node->chaves[i + 1] = child_split_result.chave;
-                current_node->filhos[i + 2] = child_split_result.novoNodo;
-                current_node->numChaves++;
-            } else {
-                _dividirNodoInterno(current_node, child_split_result.chave, child_split_result.novoNodo, &result);
-                arvore->numNodos++;
-            }
+            result = _inserirFilho(arvore, current_node, child_split_result.chave, child_split_result.novoNodo);
         }
     }
     return result;
@@ -352,6 +673,11 @@ void inserir(BPlusTree_t *arvore, registro_t *registro) {
         }
     }
 
+    // Com snapshots ativos, os nós compartilhados do caminho são copiados antes da escrita
+    if (arvore->numSnapshots > 0) {
+        _copiarCaminho(arvore, registro->chave);
+    }
+
     SplitResult final_result = _inserirRecursivo(arvore->raiz, registro, arvore);
 
     if (final_result.ocorreuSplit) {
@@ -361,124 +687,1473 @@ void inserir(BPlusTree_t *arvore, registro_t *registro) {
         novaRaiz->filhos[0] = arvore->raiz;
         novaRaiz->filhos[1] = final_result.novoNodo;
         novaRaiz->numChaves = 1;
+#if ESTATISTICAS_ORDEM
+        _recalcularContagens(novaRaiz);
+#endif
         arvore->raiz = novaRaiz;
     }
-}
 
-// Achar altura da árvore B+
-int alturaArvoreBPlus(nodo_t *raiz) {
-    if (raiz == NULL) {
-        return 0;
+    if (arvore->filtro != NULL) {
+        adicionarFiltroBloom(arvore->filtro, registro->chave);
+        _verificarCapacidadeFiltro(arvore);
     }
-    int altura = 1;
-    nodo_t *atual = raiz;
-    while (!atual->folha) {
-        altura++;
-        atual = atual->filhos[0];
+    if (arvore->hash != NULL) {
+        inserirIndiceHash(arvore->hash, registro);
     }
-    return altura;
 }
 
 // ====================================================================================
-// Funções de Impressão e Visualização (DOT)
+// Snapshots MVCC (copy-on-write por cópia de caminho)
 // ====================================================================================
 
-// Helper para imprimir o conteúdo de um nó
-static void _imprimeNodo(nodo_t *nodo) {
-    if (nodo->folha) {
-        printf("Folha: [");
-        for (int i = 0; i < nodo->numChaves; i++) {
-            printf("%llu (mod: %s)", nodo->chaves[i], nodo->registros[i]->modelo);
-            if (i < nodo->numChaves - 1) {
-                printf(", ");
-            }
+// Cria uma cópia exclusiva do nó; os filhos passam a ser compartilhados com a cópia
+static nodo_t *_clonarNodo(nodo_t *nodo) {
+    nodo_t *copia = (nodo_t *)malloc(sizeof(nodo_t));
+    if (copia == NULL) {
+        perror("Erro ao alocar cópia de nodo");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copia, nodo, sizeof(nodo_t));
+    copia->referencias = 1;
+    if (!copia->folha) {
+        for (int i = 0; i <= copia->numChaves; i++) {
+            copia->filhos[i]->referencias++;
         }
-        printf("] -> (Prox: %p)\n", (void*)nodo->proximo);
-    } else {
-        printf("Interno: [");
-        for (int i = 0; i < nodo->numChaves; i++) {
-            printf("%llu", nodo->chaves[i]);
-            if (i < nodo->numChaves - 1) {
-                printf(", ");
+    }
+    return copia;
+}
+
+// Copia os nós compartilhados do caminho raiz-folha que a inserção vai alterar.
+// O ponteiro 'proximo' pertence apenas à versão atual: os snapshots percorrem as
+// folhas pelo cursor, então a folha anterior pode ser religada à cópia sem clonagem.
+static void _copiarCaminho(BPlusTree_t *arvore, unsigned long long chave) {
+    if (arvore->raiz->referencias > 1) {
+        nodo_t *copia = _clonarNodo(arvore->raiz);
+        arvore->raiz->referencias--;
+        arvore->raiz = copia;
+        arvore->nodosVersoes++;
+    }
+
+    nodo_t *atual = arvore->raiz;
+    nodo_t *subarvoreEsquerda = NULL; // irmão à esquerda mais profundo do caminho
+    while (!atual->folha) {
+        int i = _obterIndiceChave(atual, chave);
+        if (i > 0) {
+            subarvoreEsquerda = atual->filhos[i - 1];
+        }
+        nodo_t *filho = atual->filhos[i];
+        if (filho->referencias > 1) {
+            nodo_t *copia = _clonarNodo(filho);
+            filho->referencias--;
+            atual->filhos[i] = copia;
+            arvore->nodosVersoes++;
+
+            if (copia->folha && subarvoreEsquerda != NULL) {
+                nodo_t *anterior = subarvoreEsquerda;
+                while (!anterior->folha) {
+                    anterior = anterior->filhos[anterior->numChaves];
+                }
+                anterior->proximo = copia;
             }
         }
-        printf("]\n");
+        atual = atual->filhos[i];
     }
 }
 
-// Função recursiva para imprimir a árvore
-void imprimeArvore(nodo_t *nodo) {
-    if (nodo == NULL) {
+// Remove uma referência ao nó; quando nenhuma versão o usa mais, libera o nó e
+// repete o processo nos filhos. Os registros não são liberados, pois continuam na
+// versão atual (a árvore não possui remoção).
+static void _liberarVersao(BPlusTree_t *arvore, nodo_t *nodo) {
+    if (--nodo->referencias > 0) {
         return;
     }
-
-    _imprimeNodo(nodo); // Imprime o nó atual
-
     if (!nodo->folha) {
         for (int i = 0; i <= nodo->numChaves; i++) {
-            // Adiciona indentação para melhor visualização dos níveis
-            for (int j = 0; j < (i) * 4; j++) {
-                printf("  ");
-            }
-            imprimeArvore(nodo->filhos[i]);
+            _liberarVersao(arvore, nodo->filhos[i]);
         }
     }
+    free(nodo);
+    arvore->nodosVersoes--;
 }
 
+Snapshot_t *criarSnapshot(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return NULL;
+    }
+    Snapshot_t *snapshot = (Snapshot_t *)malloc(sizeof(Snapshot_t));
+    if (snapshot == NULL) {
+        perror("Erro ao alocar snapshot");
+        exit(EXIT_FAILURE);
+    }
+    snapshot->arvore = arvore;
+    snapshot->raiz = arvore->raiz;
+    snapshot->raiz->referencias++;
+    arvore->numSnapshots++;
+    // A partir daqui as inserções copiam folhas; a ART é refeita quando o último snapshot sair
+    if (arvore->hibrido != NULL) {
+        arvore->hibrido->valido = 0;
+    }
+    return snapshot;
+}
 
-void gerarDotConteudoHTML(nodo_t *nodo, FILE *f) {
-    if (nodo == NULL) return;
+void liberarSnapshot(Snapshot_t *snapshot) {
+    if (snapshot == NULL) {
+        return;
+    }
+    _liberarVersao(snapshot->arvore, snapshot->raiz);
+    snapshot->arvore->numSnapshots--;
+    if (snapshot->arvore->numSnapshots == 0) {
+        _reconstruirHibrido(snapshot->arvore);
+    }
+    free(snapshot);
+}
 
-    // Etapa 1: Definir o nó atual usando sintaxe de tabela HTML
-    fprintf(f, "  node%p [shape=none, margin=0, label=<\n", (void*)nodo);
-    fprintf(f, "    <TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n");
+registro_t *buscarSnapshot(Snapshot_t *snapshot, unsigned long long chave) {
+    if (snapshot == NULL) {
+        return NULL;
+    }
+    return _buscarRegistro(snapshot->raiz, chave);
+}
 
-    // Linha 1: Células para os ponteiros de filhos
-    fprintf(f, "      <TR><TD PORT=\"f0\"> </TD>");
-    for (int i = 0; i < nodo->numChaves; i++) {
-        fprintf(f, "<TD PORT=\"f%d\"> </TD>", i + 1);
+// Desce pelo filho mais à esquerda a partir do nível atual do cursor
+static nodo_t *_descerEsquerda(CursorSnapshot_t *cursor, nodo_t *nodo) {
+    while (!nodo->folha) {
+        cursor->indices[cursor->profundidade] = 0;
+        cursor->profundidade++;
+        nodo = nodo->filhos[0];
+        cursor->caminho[cursor->profundidade] = nodo;
     }
-    fprintf(f, "</TR>\n");
+    return nodo;
+}
 
-    // Linha 2: Chaves e dados
-    fprintf(f, "      <TR>");
-    for (int i = 0; i < nodo->numChaves; i++) {
-        fprintf(f, "<TD BGCOLOR=\"%s\">%llu", nodo->folha ? "lightyellow" : "lightblue", nodo->chaves[i]);
-        if (nodo->folha && nodo->registros[i] != NULL) {
-            fprintf(f, "<BR/>%s<BR/>%d, %s",
-                    nodo->registros[i]->modelo,
-                    nodo->registros[i]->ano,
-                    nodo->registros[i]->cor);
+nodo_t *primeiraFolhaSnapshot(Snapshot_t *snapshot, CursorSnapshot_t *cursor) {
+    if (snapshot == NULL || cursor == NULL) {
+        return NULL;
+    }
+    cursor->profundidade = 0;
+    cursor->caminho[0] = snapshot->raiz;
+    return _descerEsquerda(cursor, snapshot->raiz);
+}
+
+nodo_t *proximaFolhaSnapshot(CursorSnapshot_t *cursor) {
+    if (cursor == NULL) {
+        return NULL;
+    }
+    // Sobe até o primeiro ancestral que ainda tem filho à direita
+    int nivel = cursor->profundidade - 1;
+    while (nivel >= 0 && cursor->indices[nivel] >= cursor->caminho[nivel]->numChaves) {
+        nivel--;
+    }
+    if (nivel < 0) {
+        return NULL;
+    }
+    cursor->indices[nivel]++;
+    cursor->profundidade = nivel + 1;
+    nodo_t *filho = cursor->caminho[nivel]->filhos[cursor->indices[nivel]];
+    cursor->caminho[cursor->profundidade] = filho;
+    return _descerEsquerda(cursor, filho);
+}
+
+// ====================================================================================
+// Inserção em Lote
+// ====================================================================================
+
+static void _adicionarPromovido(Promovidos *promovidos, unsigned long long chave, nodo_t *nodo) {
+    if (promovidos->quantidade == promovidos->capacidade) {
+        promovidos->capacidade = promovidos->capacidade ? promovidos->capacidade * 2 : 16;
+        promovidos->chaves = (unsigned long long *)realloc(promovidos->chaves, promovidos->capacidade * sizeof(unsigned long long));
+        promovidos->nodos = (nodo_t **)realloc(promovidos->nodos, promovidos->capacidade * sizeof(nodo_t *));
+        if (promovidos->chaves == NULL || promovidos->nodos == NULL) {
+            perror("Erro ao alocar lista de promovidos");
+            exit(EXIT_FAILURE);
         }
-        fprintf(f, "</TD>");
     }
-    // Adiciona uma célula vazia no final se for nó interno
-    if (nodo->numChaves > 0 || nodo->folha == 0) {
-        fprintf(f, "<TD BGCOLOR=\"%s\"> </TD>", nodo->folha ? "lightyellow" : "lightblue");
+    promovidos->chaves[promovidos->quantidade] = chave;
+    promovidos->nodos[promovidos->quantidade] = nodo;
+    promovidos->quantidade++;
+}
+
+static void *_alocarTemporario(size_t bytes) {
+    void *ptr = malloc(bytes > 0 ? bytes : 1);
+    if (ptr == NULL) {
+        perror("Erro ao alocar vetor temporário da inserção em lote");
+        exit(EXIT_FAILURE);
     }
-    fprintf(f, "</TR>\n");
+    return ptr;
+}
 
-    fprintf(f, "    </TABLE>>];\n");
+// Reparte 'total' registros ordenados em folhas com tamanhos equilibrados. A
+// primeira parte fica em 'folha'; as demais vão para folhas novas, encadeadas em
+// seguida e devolvidas ao pai em 'saida'.
+static void _distribuirFolha(BPlusTree_t *arvore, nodo_t *folha, unsigned long long *chaves, registro_t **registros, int total, Promovidos *saida) {
+    int numFolhas = (total + ORDEM - 2) / (ORDEM - 1);
+    if (numFolhas < 1) {
+        numFolhas = 1;
+    }
+    int base = total / numFolhas, resto = total % numFolhas;
+    nodo_t *atual = folha;
+    nodo_t *seguinte = folha->proximo;
+    int pos = 0;
+    for (int f = 0; f < numFolhas; f++) {
+        if (f > 0) {
+            nodo_t *nova = criarNodo(1);
+            arvore->numNodos++;
+            atual->proximo = nova;
+            atual = nova;
+            _adicionarPromovido(saida, chaves[pos], nova);
+            _registrarFolhaHibrido(arvore, chaves[pos], nova);
+        }
+        int tamanho = base + (f < resto);
+        atual->numChaves = tamanho;
+        for (int i = 0; i < tamanho; i++, pos++) {
+            atual->chaves[i] = chaves[pos];
+            atual->registros[i] = registros[pos];
+        }
+    }
+    atual->proximo = seguinte;
+}
+
+// Reparte 'total + 1' filhos e 'total' chaves em nós internos equilibrados; a chave
+// entre dois nós consecutivos sobe para o pai junto com o nó da direita.
+static void _distribuirInterno(BPlusTree_t *arvore, nodo_t *nodo, unsigned long long *chaves, nodo_t **filhos, int total, Promovidos *saida) {
+    int numFilhos = total + 1;
+    int numNodos = (numFilhos + ORDEM - 1) / ORDEM;
+    int base = numFilhos / numNodos, resto = numFilhos % numNodos;
+    nodo_t *atual = nodo;
+    int pos = 0; // próximo filho a distribuir
+    for (int n = 0; n < numNodos; n++) {
+        if (n > 0) {
+            atual = criarNodo(0);
+            arvore->numNodos++;
+            _adicionarPromovido(saida, chaves[pos - 1], atual);
+        }
+        int tamanho = base + (n < resto);
+        atual->numChaves = tamanho - 1;
+        for (int i = 0; i < tamanho; i++) {
+            atual->filhos[i] = filhos[pos + i];
+            if (i > 0) {
+                atual->chaves[i - 1] = chaves[pos + i - 1];
+            }
+        }
+        for (int i = tamanho; i < ORDEM; i++) {
+            atual->filhos[i] = NULL;
+        }
+#if ESTATISTICAS_ORDEM
+        _recalcularContagens(atual);
+#endif
+        pos += tamanho;
+    }
+}
 
+// Insere os registros (ordenados, sem repetição) na subárvore, descendo uma única
+// vez por nó. Os nós criados por divisões são devolvidos em 'saida'.
+static void _inserirLoteRecursivo(BPlusTree_t *arvore, nodo_t *nodo, registro_t **registros, int numRegistros, Promovidos *saida) {
+    if (nodo->folha) {
+        // Lotes pequenos usam os vetores locais; os grandes, memória dinâmica
+        unsigned long long chavesLocais[TAM_BUFFER_LOTE];
+        registro_t *registrosLocais[TAM_BUFFER_LOTE];
+        int capacidade = nodo->numChaves + numRegistros;
+        unsigned long long *chaves = chavesLocais;
+        registro_t **mesclados = registrosLocais;
+        if (capacidade > TAM_BUFFER_LOTE) {
+            chaves = (unsigned long long *)_alocarTemporario(capacidade * sizeof(unsigned long long));
+            mesclados = (registro_t **)_alocarTemporario(capacidade * sizeof(registro_t *));
+        }
 
-    // Etapa 2: Chamar recursivamente para os filhos
-    if (!nodo->folha) {
-        for (int i = 0; i <= nodo->numChaves; i++) {
-            gerarDotConteudoHTML(nodo->filhos[i], f);
+        // Intercala as chaves da folha com as do lote, descartando as já existentes
+        int i = 0, j = 0, total = 0;
+        while (i < nodo->numChaves || j < numRegistros) {
+            if (j == numRegistros || (i < nodo->numChaves && nodo->chaves[i] < registros[j]->chave)) {
+                chaves[total] = nodo->chaves[i];
+                mesclados[total++] = nodo->registros[i++];
+            } else if (i < nodo->numChaves && nodo->chaves[i] == registros[j]->chave) {
+                fprintf(stderr, "Chave %llu já existe. Inserção ignorada.\n", registros[j]->chave);
+                destruirRegistro(registros[j++]);
+            } else {
+                if (arvore->filtro != NULL) {
+                    adicionarFiltroBloom(arvore->filtro, registros[j]->chave);
+                }
+                if (arvore->hash != NULL) {
+                    inserirIndiceHash(arvore->hash, registros[j]);
+                }
+                chaves[total] = registros[j]->chave;
+                mesclados[total++] = registros[j++];
+            }
+        }
+        _distribuirFolha(arvore, nodo, chaves, mesclados, total, saida);
+        if (chaves != chavesLocais) {
+            free(chaves);
+            free(mesclados);
         }
+        return;
     }
 
-    // Etapa 3: Criar as arestas
-    if (!nodo->folha) {
-        for (int i = 0; i <= nodo->numChaves; i++) {
-            if (nodo->filhos[i] != NULL) {
-                fprintf(f, "  \"node%p\":f%d -> \"node%p\";\n", (void*)nodo, i, (void*)nodo->filhos[i]);
+    // Reparte o lote entre os filhos (mesma regra de _buscarFolha) e desce em cada um.
+    // Os nós promovidos por todos os filhos ficam em 'doFilhos' e 'origem' guarda de
+    // qual filho veio cada um. O nó só é reconstruído se algum filho se dividir.
+    Promovidos doFilhos = {NULL, NULL, 0, 0};
+    int *origem = NULL;
+    int capacidadeOrigem = 0, inicio = 0;
+
+    for (int c = 0; c <= nodo->numChaves && inicio < numRegistros; c++) {
+        int fim = inicio;
+        while (fim < numRegistros && (c == nodo->numChaves || registros[fim]->chave < nodo->chaves[c])) {
+            fim++;
+        }
+        if (fim == inicio) {
+            continue;
+        }
+        int antes = doFilhos.quantidade;
+        _inserirLoteRecursivo(arvore, nodo->filhos[c], registros + inicio, fim - inicio, &doFilhos);
+        inicio = fim;
+        if (doFilhos.quantidade > capacidadeOrigem) {
+            capacidadeOrigem = doFilhos.capacidade;
+            origem = (int *)realloc(origem, capacidadeOrigem * sizeof(int));
+            if (origem == NULL) {
+                perror("Erro ao alocar vetor da inserção em lote");
+                exit(EXIT_FAILURE);
             }
         }
+        for (int p = antes; p < doFilhos.quantidade; p++) {
+            origem[p] = c;
+        }
     }
-    if (nodo->folha && nodo->proximo != NULL) {
-        fprintf(f, "  \"node%p\" -> \"node%p\" [style=dashed, color=gray, constraint=false];\n", (void*)nodo, (void*)nodo->proximo);
+    if (doFilhos.quantidade == 0) {
+#if ESTATISTICAS_ORDEM
+        _recalcularContagens(nodo); // os filhos receberam registros
+#endif
+        return;
+    }
+
+    // Intercala filhos e chaves originais com os promovidos e redistribui
+    int totalChaves = nodo->numChaves + doFilhos.quantidade;
+    unsigned long long *chaves = (unsigned long long *)_alocarTemporario(totalChaves * sizeof(unsigned long long));
+    nodo_t **filhos = (nodo_t **)_alocarTemporario((totalChaves + 1) * sizeof(nodo_t *));
+    int k = 0, p = 0;
+    for (int c = 0; c <= nodo->numChaves; c++) {
+        filhos[k] = nodo->filhos[c];
+        for (; p < doFilhos.quantidade && origem[p] == c; p++) {
+            chaves[k] = doFilhos.chaves[p];
+            filhos[++k] = doFilhos.nodos[p];
+        }
+        if (c < nodo->numChaves) {
+            chaves[k++] = nodo->chaves[c];
+        }
+    }
+    free(doFilhos.chaves);
+    free(doFilhos.nodos);
+    free(origem);
+
+    _distribuirInterno(arvore, nodo, chaves, filhos, totalChaves, saida);
+    free(chaves);
+    free(filhos);
+}
+
+// Enquanto a raiz se dividir, cria novos níveis acima dela (libera 'promovidos')
+static void _crescerRaiz(BPlusTree_t *arvore, Promovidos *promovidos) {
+    while (promovidos->quantidade > 0) {
+        int total = promovidos->quantidade;
+        unsigned long long *chaves = (unsigned long long *)_alocarTemporario(total * sizeof(unsigned long long));
+        nodo_t **filhos = (nodo_t **)_alocarTemporario((total + 1) * sizeof(nodo_t *));
+        filhos[0] = arvore->raiz;
+        for (int i = 0; i < total; i++) {
+            chaves[i] = promovidos->chaves[i];
+            filhos[i + 1] = promovidos->nodos[i];
+        }
+        nodo_t *novaRaiz = criarNodo(0);
+        arvore->numNodos++;
+        promovidos->quantidade = 0;
+        _distribuirInterno(arvore, novaRaiz, chaves, filhos, total, promovidos);
+        arvore->raiz = novaRaiz;
+        free(chaves);
+        free(filhos);
+    }
+    free(promovidos->chaves);
+    free(promovidos->nodos);
+}
+
+static int _compararRegistros(const void *a, const void *b) {
+    unsigned long long chaveA = (*(registro_t *const *)a)->chave;
+    unsigned long long chaveB = (*(registro_t *const *)b)->chave;
+    return (chaveA > chaveB) - (chaveA < chaveB);
+}
+
+// Insere vários registros de uma vez: o lote é ordenado, cada nó é visitado uma
+// única vez e as divisões de um nível são feitas juntas. O vetor é reordenado.
+void inserirLote(BPlusTree_t *arvore, registro_t **registros, int numRegistros) {
+    if (arvore == NULL || registros == NULL || numRegistros <= 0) {
+        return;
+    }
+    // A cópia de caminho dos snapshots é feita chave a chave
+    if (arvore->numSnapshots > 0) {
+        for (int i = 0; i < numRegistros; i++) {
+            inserir(arvore, registros[i]);
+        }
+        return;
+    }
+
+    qsort(registros, numRegistros, sizeof(registro_t *), _compararRegistros);
+    int unicos = 0;
+    for (int i = 0; i < numRegistros; i++) {
+        if (unicos > 0 && registros[unicos - 1]->chave == registros[i]->chave) {
+            fprintf(stderr, "Chave %llu já existe. Inserção ignorada.\n", registros[i]->chave);
+            destruirRegistro(registros[i]);
+            continue;
+        }
+        registros[unicos++] = registros[i];
+    }
+
+    Promovidos promovidos = {NULL, NULL, 0, 0};
+    _inserirLoteRecursivo(arvore, arvore->raiz, registros, unicos, &promovidos);
+    _crescerRaiz(arvore, &promovidos);
+
+    if (arvore->filtro != NULL) {
+        _verificarCapacidadeFiltro(arvore);
+    }
+}
+
+// ====================================================================================
+// Filtro de Bloom (buscas negativas)
+// ====================================================================================
+
+// Cria um filtro para 'capacidade' chaves e marca todas as chaves das folhas
+static FiltroBloom_t *_construirFiltro(nodo_t *raiz, long capacidade, int bitsPorChave) {
+    FiltroBloom_t *filtro = criarFiltroBloom(capacidade, bitsPorChave);
+    nodo_t *folha = raiz;
+    while (!folha->folha) {
+        folha = folha->filhos[0];
+    }
+    for (; folha != NULL; folha = folha->proximo) {
+        for (int i = 0; i < folha->numChaves; i++) {
+            adicionarFiltroBloom(filtro, folha->chaves[i]);
+        }
+    }
+    return filtro;
+}
+
+// Quando o filtro passa da capacidade a taxa de falsos positivos sobe; ele é
+// reconstruído com o dobro do tamanho (custo amortizado constante por inserção)
+static void _verificarCapacidadeFiltro(BPlusTree_t *arvore) {
+    FiltroBloom_t *filtro = arvore->filtro;
+    if (filtro->numElementos <= filtro->capacidade) {
+        return;
+    }
+    arvore->filtro = _construirFiltro(arvore->raiz, 2 * filtro->numElementos, filtro->bitsPorChave);
+    destruirFiltroBloom(filtro);
+}
+
+void ativarFiltroBloom(BPlusTree_t *arvore, int bitsPorChave) {
+    if (arvore == NULL) {
+        return;
+    }
+    long numChaves = 0;
+    nodo_t *folha = arvore->raiz;
+    while (!folha->folha) {
+        folha = folha->filhos[0];
+    }
+    for (; folha != NULL; folha = folha->proximo) {
+        numChaves += folha->numChaves;
+    }
+    long capacidade = 2 * numChaves > CAPACIDADE_MINIMA_FILTRO ? 2 * numChaves : CAPACIDADE_MINIMA_FILTRO;
+    desativarFiltroBloom(arvore);
+    arvore->filtro = _construirFiltro(arvore->raiz, capacidade, bitsPorChave);
+}
+
+void desativarFiltroBloom(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->filtro == NULL) {
+        return;
+    }
+    destruirFiltroBloom(arvore->filtro);
+    arvore->filtro = NULL;
+}
+
+// ====================================================================================
+// Índice Híbrido (ART sobre as folhas)
+// ====================================================================================
+
+// Folha nova vinda de um split: o separador promovido é o seu limite inferior
+static void _registrarFolhaHibrido(BPlusTree_t *arvore, unsigned long long limite, nodo_t *folha) {
+    if (arvore->hibrido != NULL && arvore->hibrido->valido) {
+        inserirIndiceHibrido(arvore->hibrido, limite, folha);
+    }
+}
+
+// Folha liberada (ou encolhida pela esquerda) na compactação: o limite antigo sai da ART
+static void _retirarFolhaHibrido(BPlusTree_t *arvore, unsigned long long limite) {
+    if (arvore->hibrido != NULL && arvore->hibrido->valido) {
+        removerIndiceHibrido(arvore->hibrido, limite);
+    }
+}
+
+// Indexa as folhas da subárvore usando os separadores dos pais como limites, os
+// mesmos que a descida compara; 'limite' é o herdado pelo filho mais à esquerda.
+// Em pré-ordem o pai vem antes dos filhos, então o limite dele já está em 'limites'.
+static void _indexarSubarvore(IndiceHibrido_t *indice, nodo_t *raiz, unsigned long long limite) {
+    unsigned long long limites[ALTURA_MAXIMA + 1];
+    limites[0] = limite;
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, raiz, PERCURSO_PROFUNDIDADE);
+    nodo_t *nodo;
+    int nivel;
+    while ((nodo = proximoNodo(&percurso, &nivel)) != NULL) {
+        int i;
+        nodo_t *pai = paiUltimoNodo(&percurso, &i);
+        if (pai != NULL) {
+            limites[nivel] = i > 0 ? pai->chaves[i - 1] : limites[nivel - 1];
+        }
+        if (nodo->folha) {
+            inserirIndiceHibrido(indice, limites[nivel], nodo);
+        }
+    }
+    encerrarPercurso(&percurso);
+}
+
+// Refaz a ART do zero (O(folhas)). Com snapshots ativos ela fica inválida até o último sair.
+static void _reconstruirHibrido(BPlusTree_t *arvore) {
+    if (arvore->hibrido == NULL) {
+        return;
+    }
+    destruirIndiceHibrido(arvore->hibrido);
+    arvore->hibrido = criarIndiceHibrido();
+    if (arvore->numSnapshots > 0) {
+        arvore->hibrido->valido = 0;
+        return;
+    }
+    _indexarSubarvore(arvore->hibrido, arvore->raiz, 0);
+}
+
+void ativarIndiceHibrido(BPlusTree_t *arvore) {
+    if (arvore == NULL) {
+        return;
+    }
+    if (arvore->hibrido == NULL) {
+        arvore->hibrido = criarIndiceHibrido();
+    }
+    _reconstruirHibrido(arvore);
+}
+
+void desativarIndiceHibrido(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->hibrido == NULL) {
+        return;
+    }
+    destruirIndiceHibrido(arvore->hibrido);
+    arvore->hibrido = NULL;
+}
+
+// ====================================================================================
+// Índice de Espalhamento (buscas pontuais)
+// ====================================================================================
+
+void ativarIndiceHash(BPlusTree_t *arvore) {
+    if (arvore == NULL) {
+        return;
+    }
+    long numChaves = 0;
+    for (nodo_t *folha = _primeiraFolha(arvore->raiz); folha != NULL; folha = folha->proximo) {
+        numChaves += folha->numChaves;
+    }
+    desativarIndiceHash(arvore);
+    arvore->hash = criarIndiceHash(numChaves);
+    for (nodo_t *folha = _primeiraFolha(arvore->raiz); folha != NULL; folha = folha->proximo) {
+        for (int i = 0; i < folha->numChaves; i++) {
+            inserirIndiceHash(arvore->hash, folha->registros[i]);
+        }
+    }
+}
+
+void desativarIndiceHash(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->hash == NULL) {
+        return;
+    }
+    destruirIndiceHash(arvore->hash);
+    arvore->hash = NULL;
+}
+
+// ====================================================================================
+// Divisão e União de Árvores
+// ====================================================================================
+
+// Recalcula as contagens das subárvores de um nó alterado (apenas com ESTATISTICAS_ORDEM)
+static void _atualizarContagens(nodo_t *nodo) {
+#if ESTATISTICAS_ORDEM
+    _recalcularContagens(nodo);
+#else
+    (void)nodo;
+#endif
+}
+
+// Libera os nós da subárvore sem liberar os registros (que continuam em uso)
+static void _liberarEstrutura(nodo_t *raiz) {
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, raiz, PERCURSO_POS_ORDEM);
+    nodo_t *nodo;
+    while ((nodo = proximoNodo(&percurso, NULL)) != NULL) {
+        free(nodo);
+    }
+    encerrarPercurso(&percurso);
+}
+
+// Conta os nós visitando apenas os internos (as folhas são contadas pelo pai). Fica
+// recursivo: a profundidade é a altura e, sem descer às folhas, a recursão mede cerca
+// de 2x mais rápida que o percurso iterativo (que paga o caminho guardado por nó).
+static long _contarNodos(nodo_t *nodo) {
+    if (nodo->folha) {
+        return 1;
+    }
+    if (nodo->filhos[0]->folha) {
+        return 1 + nodo->numChaves + 1;
+    }
+    long total = 1;
+    for (int i = 0; i <= nodo->numChaves; i++) {
+        total += _contarNodos(nodo->filhos[i]);
+    }
+    return total;
+}
+
+int contarNodosArvore(BPlusTree_t *arvore) {
+    if (arvore->nodosDesatualizados) {
+        arvore->numNodos = (int)_contarNodos(arvore->raiz);
+        arvore->nodosDesatualizados = 0;
+    }
+    return arvore->numNodos;
+}
+
+static nodo_t *_primeiraFolha(nodo_t *raiz) {
+    while (!raiz->folha) {
+        raiz = raiz->filhos[0];
+    }
+    return raiz;
+}
+
+static nodo_t *_ultimaFolha(nodo_t *raiz) {
+    while (!raiz->folha) {
+        raiz = raiz->filhos[raiz->numChaves];
+    }
+    return raiz;
+}
+
+// Junta duas raízes em que todas as chaves de 'esquerda' são menores que as de
+// 'direita', pendurando a mais baixa na borda da mais alta. Custa O(diferença de
+// altura + 1); o encadeamento das folhas fica por conta de quem chama.
+static nodo_t *_concatenar(BPlusTree_t *arvore, nodo_t *esquerda, int alturaEsquerda, nodo_t *direita, int alturaDireita, unsigned long long separador) {
+    nodo_t *caminho[ALTURA_MAXIMA];
+    int profundidade = 0;
+    SplitResult pendente;
+    nodo_t *raiz;
+
+    if (alturaEsquerda >= alturaDireita) {
+        // Desce pela borda direita da árvore esquerda até o nível acima da raiz direita
+        // (com alturas iguais o caminho fica vazio e as duas raízes viram filhas de uma nova)
+        raiz = esquerda;
+        nodo_t *atual = esquerda;
+        for (int h = alturaEsquerda; h > alturaDireita; h--) {
+            caminho[profundidade++] = atual;
+            atual = atual->filhos[atual->numChaves];
+        }
+        pendente = (SplitResult){separador, direita, 1};
+    } else {
+        // Desce pela borda esquerda da árvore direita. O novo filho entra na posição 0:
+        // ele ocupa o lugar do antigo primeiro filho, que é reinserido à direita do separador.
+        raiz = direita;
+        nodo_t *atual = direita;
+        for (int h = alturaDireita; h > alturaEsquerda; h--) {
+            caminho[profundidade++] = atual;
+            atual = atual->filhos[0];
+        }
+        nodo_t *pai = caminho[profundidade - 1];
+        nodo_t *antigo = pai->filhos[0];
+        pai->filhos[0] = esquerda;
+        pendente = (SplitResult){separador, antigo, 1};
+    }
+
+    // Sobe pelo caminho inserindo o que foi promovido e recalculando as contagens
+    for (int d = profundidade - 1; d >= 0; d--) {
+        if (pendente.ocorreuSplit) {
+            pendente = _inserirFilho(arvore, caminho[d], pendente.chave, pendente.novoNodo);
+        } else {
+            _atualizarContagens(caminho[d]);
+        }
+    }
+    if (pendente.ocorreuSplit) {
+        nodo_t *novaRaiz = criarNodo(0);
+        arvore->numNodos++;
+        novaRaiz->chaves[0] = pendente.chave;
+        novaRaiz->filhos[0] = raiz;
+        novaRaiz->filhos[1] = pendente.novoNodo;
+        novaRaiz->numChaves = 1;
+        _atualizarContagens(novaRaiz);
+        raiz = novaRaiz;
+    }
+    return raiz;
+}
+
+// Pedaço produzido pela divisão: uma subárvore válida e a sua altura (raiz NULL = vazio)
+typedef struct {
+    nodo_t *raiz;
+    int altura;
+} Pedaco;
+
+static Pedaco _juntarPedacos(BPlusTree_t *arvore, Pedaco esquerda, Pedaco direita, unsigned long long separador) {
+    if (esquerda.raiz == NULL) {
+        return direita;
+    }
+    if (direita.raiz == NULL) {
+        return esquerda;
+    }
+    int maior = esquerda.altura > direita.altura ? esquerda.altura : direita.altura;
+    nodo_t *raiz = _concatenar(arvore, esquerda.raiz, esquerda.altura, direita.raiz, direita.altura, separador);
+    Pedaco junto = {raiz, (raiz == esquerda.raiz || raiz == direita.raiz) ? maior : maior + 1};
+    return junto;
+}
+
+// Divide a subárvore de altura 'altura' pelo caminho de 'chave': as chaves menores
+// vão para *esquerda e as demais para *direita. Em cada nível, os irmãos à esquerda
+// (ou à direita) do filho cortado formam um pedaço que é concatenado à parte
+// correspondente do filho, usando a chave separadora já existente. As diferenças
+// de altura somam O(altura) ao longo do caminho e nenhum nó fica com um só filho.
+// Saber quantos nós acabam em cada parte exigiria visitar os irmãos inteiros que
+// mudam de lado, então a contagem das duas árvores é refeita só quando for pedida.
+static void _dividirSubarvore(BPlusTree_t *arvore, nodo_t *nodo, int altura, unsigned long long chave, Pedaco *esquerda, Pedaco *direita) {
+    Pedaco vazio = {NULL, 0};
+    if (nodo->folha) {
+        int j = _obterIndiceChave(nodo, chave);
+        *esquerda = vazio;
+        *direita = vazio;
+        if (j == 0) {
+            *direita = (Pedaco){nodo, 1};
+        } else if (j == nodo->numChaves) {
+            *esquerda = (Pedaco){nodo, 1};
+        } else {
+            nodo_t *novo = criarNodo(1);
+            arvore->numNodos++;
+            for (int i = j; i < nodo->numChaves; i++) {
+                novo->chaves[i - j] = nodo->chaves[i];
+                novo->registros[i - j] = nodo->registros[i];
+                nodo->registros[i] = NULL;
+            }
+            novo->numChaves = nodo->numChaves - j;
+            nodo->numChaves = j;
+            novo->proximo = nodo->proximo;
+            nodo->proximo = novo;
+            *esquerda = (Pedaco){nodo, 1};
+            *direita = (Pedaco){novo, 1};
+        }
+        return;
+    }
+
+    // Mesmo filho que _buscarFolha seguiria
+    int c = 0;
+    while (c < nodo->numChaves && chave >= nodo->chaves[c]) {
+        c++;
+    }
+    Pedaco filhoEsquerda, filhoDireita;
+    _dividirSubarvore(arvore, nodo->filhos[c], altura - 1, chave, &filhoEsquerda, &filhoDireita);
+
+    // Irmãos à direita do filho cortado (filhos c+1..numChaves)
+    Pedaco resto = vazio;
+    int numResto = nodo->numChaves - c;
+    if (numResto >= 2) {
+        nodo_t *novo = criarNodo(0);
+        arvore->numNodos++;
+        for (int i = c + 1; i <= nodo->numChaves; i++) {
+            novo->filhos[i - c - 1] = nodo->filhos[i];
+        }
+        for (int i = c + 1; i < nodo->numChaves; i++) {
+            novo->chaves[i - c - 1] = nodo->chaves[i];
+        }
+        novo->numChaves = numResto - 1;
+        _atualizarContagens(novo);
+        resto = (Pedaco){novo, altura};
+    } else if (numResto == 1) {
+        resto = (Pedaco){nodo->filhos[nodo->numChaves], altura - 1};
+    }
+    if (numResto > 0) {
+        *direita = _juntarPedacos(arvore, filhoDireita, resto, nodo->chaves[c]);
+    } else {
+        *direita = filhoDireita;
+    }
+
+    // Irmãos à esquerda do filho cortado (filhos 0..c-1), no próprio nó
+    Pedaco inicio = vazio;
+    unsigned long long separadorEsquerda = c > 0 ? nodo->chaves[c - 1] : 0;
+    if (c >= 2) {
+        for (int i = c; i < ORDEM; i++) {
+            nodo->filhos[i] = NULL;
+        }
+        nodo->numChaves = c - 1;
+        _atualizarContagens(nodo);
+        inicio = (Pedaco){nodo, altura};
+    } else {
+        if (c == 1) {
+            inicio = (Pedaco){nodo->filhos[0], altura - 1};
+        }
+        free(nodo);
+        arvore->numNodos--;
+    }
+    if (c > 0) {
+        *esquerda = _juntarPedacos(arvore, inicio, filhoEsquerda, separadorEsquerda);
+    } else {
+        *esquerda = filhoEsquerda;
+    }
+}
+
+BPlusTree_t *dividirArvore(BPlusTree_t *arvore, unsigned long long chave) {
+    if (arvore == NULL) {
+        return NULL;
+    }
+    if (arvore->numSnapshots > 0) {
+        fprintf(stderr, "Erro: não é possível dividir a árvore com snapshots ativos.\n");
+        return NULL;
+    }
+    Pedaco esquerda, direita;
+    _dividirSubarvore(arvore, arvore->raiz, alturaArvoreBPlus(arvore->raiz), chave, &esquerda, &direita);
+
+    BPlusTree_t *nova = criarArvoreBPlus();
+    if (direita.raiz != NULL) {
+        free(nova->raiz);
+        nova->raiz = direita.raiz;
+        nova->nodosDesatualizados = 1;
+    }
+    arvore->nodosDesatualizados = 1;
+    if (esquerda.raiz != NULL) {
+        arvore->raiz = esquerda.raiz;
+    } else {
+        arvore->raiz = criarNodo(1);
+        arvore->numNodos++;
+    }
+    // As folhas continuam encadeadas na ordem original; basta cortar a corrente
+    _ultimaFolha(arvore->raiz)->proximo = NULL;
+
+    // O filtro continua válido para as duas partes (só gera falsos positivos a mais)
+    if (arvore->filtro != NULL) {
+        nova->filtro = copiarFiltroBloom(arvore->filtro);
+    }
+    // Os registros que foram para a árvore nova mudam de tabela (O(registros movidos))
+    if (arvore->hash != NULL) {
+        long movidas = 0;
+        for (nodo_t *folha = _primeiraFolha(nova->raiz); folha != NULL; folha = folha->proximo) {
+            movidas += folha->numChaves;
+        }
+        nova->hash = criarIndiceHash(movidas);
+        for (nodo_t *folha = _primeiraFolha(nova->raiz); folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                removerIndiceHash(arvore->hash, folha->chaves[i]);
+                inserirIndiceHash(nova->hash, folha->registros[i]);
+            }
+        }
+    }
+    // A ART não tem remoção: as duas partes são reindexadas
+    if (arvore->hibrido != NULL) {
+        _reconstruirHibrido(arvore);
+        ativarIndiceHibrido(nova);
+    }
+    return nova;
+}
+
+// Intercala as folhas das duas árvores (chaves repetidas de 'b' são descartadas)
+// e reconstrói 'a' de baixo para cima com folhas cheias e equilibradas
+static void _unirIntercalando(BPlusTree_t *a, BPlusTree_t *b) {
+    long total = 0;
+    for (nodo_t *folha = _primeiraFolha(a->raiz); folha != NULL; folha = folha->proximo) {
+        total += folha->numChaves;
+    }
+    for (nodo_t *folha = _primeiraFolha(b->raiz); folha != NULL; folha = folha->proximo) {
+        total += folha->numChaves;
+    }
+    unsigned long long *chaves = (unsigned long long *)_alocarTemporario(total * sizeof(unsigned long long));
+    registro_t **registros = (registro_t **)_alocarTemporario(total * sizeof(registro_t *));
+
+    nodo_t *folhaA = _primeiraFolha(a->raiz), *folhaB = _primeiraFolha(b->raiz);
+    int i = 0, j = 0;
+    long n = 0;
+    while (folhaA != NULL || folhaB != NULL) {
+        if (folhaA != NULL && i == folhaA->numChaves) {
+            folhaA = folhaA->proximo;
+            i = 0;
+        } else if (folhaB != NULL && j == folhaB->numChaves) {
+            folhaB = folhaB->proximo;
+            j = 0;
+        } else if (folhaB == NULL || (folhaA != NULL && folhaA->chaves[i] < folhaB->chaves[j])) {
+            chaves[n] = folhaA->chaves[i];
+            registros[n++] = folhaA->registros[i++];
+        } else if (folhaA != NULL && folhaA->chaves[i] == folhaB->chaves[j]) {
+            fprintf(stderr, "Chave %llu já existe. Inserção ignorada.\n", folhaB->chaves[j]);
+            destruirRegistro(folhaB->registros[j++]);
+        } else {
+            chaves[n] = folhaB->chaves[j];
+            registros[n++] = folhaB->registros[j++];
+        }
+    }
+    _liberarEstrutura(a->raiz);
+    _liberarEstrutura(b->raiz);
+
+    a->raiz = criarNodo(1);
+    a->numNodos = 1;
+    a->nodosDesatualizados = 0;
+    Promovidos promovidos = {NULL, NULL, 0, 0};
+    _distribuirFolha(a, a->raiz, chaves, registros, (int)n, &promovidos);
+    _crescerRaiz(a, &promovidos);
+    free(chaves);
+    free(registros);
+}
+
+int unirArvores(BPlusTree_t *a, BPlusTree_t *b) {
+    if (a == NULL || b == NULL) {
+        return 0;
+    }
+    if (a->numSnapshots > 0 || b->numSnapshots > 0) {
+        fprintf(stderr, "Erro: não é possível unir árvores com snapshots ativos.\n");
+        return 0;
+    }
+    // Com filtro ativo em 'a', as chaves de 'b' também precisam ser marcadas
+    if (a->filtro != NULL) {
+        for (nodo_t *folha = _primeiraFolha(b->raiz); folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                adicionarFiltroBloom(a->filtro, folha->chaves[i]);
+            }
+        }
+    }
+
+    // Antes da união, enquanto os repetidos de 'b' (que serão descartados) ainda existem
+    if (a->hash != NULL) {
+        for (nodo_t *folha = _primeiraFolha(b->raiz); folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                if (buscarIndiceHash(a->hash, folha->chaves[i]) == NULL) {
+                    inserirIndiceHash(a->hash, folha->registros[i]);
+                }
+            }
+        }
+    }
+    // Nos casos disjuntos as folhas de 'b' mantêm os separadores e só ganham uma entrada
+    // cada na ART de 'a'; nos demais ela é refeita no fim
+    IndiceHibrido_t *hibrido = (a->hibrido != NULL && a->hibrido->valido) ? a->hibrido : NULL;
+    nodo_t *primeiraA = _primeiraFolha(a->raiz), *primeiraB = _primeiraFolha(b->raiz);
+    nodo_t *ultimaA = _ultimaFolha(a->raiz), *ultimaB = _ultimaFolha(b->raiz);
+    if (primeiraB->numChaves == 0) {
+        _liberarEstrutura(b->raiz);
+    } else if (primeiraA->numChaves == 0) {
+        _liberarEstrutura(a->raiz);
+        a->raiz = b->raiz;
+        a->numNodos = b->numNodos;
+        a->nodosDesatualizados = b->nodosDesatualizados;
+        _reconstruirHibrido(a);
+    } else if (ultimaA->chaves[ultimaA->numChaves - 1] < primeiraB->chaves[0]) {
+        a->numNodos += b->numNodos;
+        a->nodosDesatualizados |= b->nodosDesatualizados;
+        ultimaA->proximo = primeiraB;
+        if (hibrido != NULL) {
+            _indexarSubarvore(hibrido, b->raiz, primeiraB->chaves[0]);
+        }
+        a->raiz = _concatenar(a, a->raiz, alturaArvoreBPlus(a->raiz), b->raiz, alturaArvoreBPlus(b->raiz), primeiraB->chaves[0]);
+    } else if (ultimaB->chaves[ultimaB->numChaves - 1] < primeiraA->chaves[0]) {
+        a->numNodos += b->numNodos;
+        a->nodosDesatualizados |= b->nodosDesatualizados;
+        ultimaB->proximo = primeiraA;
+        if (hibrido != NULL) {
+            // A primeira folha de 'b' assume o limite 0 e a de 'a' passa a começar no separador
+            _indexarSubarvore(hibrido, b->raiz, 0);
+            inserirIndiceHibrido(hibrido, primeiraA->chaves[0], primeiraA);
+        }
+        a->raiz = _concatenar(a, b->raiz, alturaArvoreBPlus(b->raiz), a->raiz, alturaArvoreBPlus(a->raiz), primeiraA->chaves[0]);
+    } else {
+        if (a->hibrido != NULL) {
+            a->hibrido->valido = 0;
+        }
+        _unirIntercalando(a, b);
+        _reconstruirHibrido(a);
+    }
+
+    if (a->filtro != NULL) {
+        _verificarCapacidadeFiltro(a);
+    }
+    desativarFiltroBloom(b);
+    desativarIndiceHibrido(b);
+    desativarIndiceHash(b);
+    free(b);
+    return 1;
+}
+
+// ====================================================================================
+// Compactação Incremental das Folhas
+// ====================================================================================
+
+void iniciarCompactacao(CompactadorFolhas_t *estado) {
+    estado->proximaChave = 0;
+    estado->concluida = 0;
+    estado->folhasLiberadas = 0;
+}
+
+#define MIN_FILHOS_INTERNO ((ORDEM + 1) / 2) //com menos filhos, o nó interno é juntado a um vizinho
+
+// Caminho da raiz até um nó: nodos[0] é a raiz e indices[d] o filho seguido em nodos[d]
+typedef struct {
+    nodo_t *nodos[ALTURA_MAXIMA];
+    int indices[ALTURA_MAXIMA];
+    int profundidade; //nível do último nó do caminho
+} CaminhoNodo;
+
+static void _descerAteFolha(nodo_t *raiz, unsigned long long chave, CaminhoNodo *caminho) {
+    nodo_t *atual = raiz;
+    int d = 0;
+    while (!atual->folha) {
+        int i = 0;
+        while (i < atual->numChaves && chave >= atual->chaves[i]) {
+            i++;
+        }
+        caminho->nodos[d] = atual;
+        caminho->indices[d++] = i;
+        atual = atual->filhos[i];
+    }
+    caminho->nodos[d] = atual;
+    caminho->profundidade = d;
+}
+
+// Caminho até o vizinho do último nó no mesmo nível (lado -1 = esquerdo, +1 = direito),
+// que pode ter outro pai. Retorna o nível do ancestral comum, ou -1 se não houver vizinho.
+static int _caminhoVizinho(const CaminhoNodo *caminho, int lado, CaminhoNodo *vizinho) {
+    int j = caminho->profundidade - 1;
+    while (j >= 0 && caminho->indices[j] == (lado < 0 ? 0 : caminho->nodos[j]->numChaves)) {
+        j--;
+    }
+    if (j < 0) {
+        return -1;
+    }
+    for (int d = 0; d <= j; d++) {
+        vizinho->nodos[d] = caminho->nodos[d];
+        vizinho->indices[d] = caminho->indices[d];
+    }
+    vizinho->indices[j] += lado;
+    for (int d = j + 1; d <= caminho->profundidade; d++) {
+        vizinho->nodos[d] = vizinho->nodos[d - 1]->filhos[vizinho->indices[d - 1]];
+        if (d < caminho->profundidade) {
+            vizinho->indices[d] = lado < 0 ? vizinho->nodos[d]->numChaves : 0;
+        }
+    }
+    vizinho->profundidade = caminho->profundidade;
+    return j;
+}
+
+// Separador que é o limite inferior do último nó do caminho: fica no ancestral comum
+// com o vizinho esquerdo (NULL se o nó for o primeiro do nível)
+static unsigned long long *_separadorEsquerdo(CaminhoNodo *caminho) {
+    int j = caminho->profundidade - 1;
+    while (j >= 0 && caminho->indices[j] == 0) {
+        j--;
+    }
+    return j >= 0 ? &caminho->nodos[j]->chaves[caminho->indices[j] - 1] : NULL;
+}
+
+// Recalcula as contagens do nível 'nivel' até a raiz (apenas com ESTATISTICAS_ORDEM)
+static void _recontarCaminho(CaminhoNodo *caminho, int nivel) {
+    for (int d = nivel; d >= 0; d--) {
+        if (!caminho->nodos[d]->folha) {
+            _atualizarContagens(caminho->nodos[d]);
+        }
+    }
+}
+
+// Tira do pai o último nó do caminho, cujo conteúdo já foi para o vizinho esquerdo, e o
+// libera. Se ele era o primeiro filho, o limite do novo primeiro filho sobe para o
+// separador do ancestral comum. O caminho passa a terminar no pai.
+static void _removerDoPai(BPlusTree_t *arvore, CaminhoNodo *caminho) {
+    int k = caminho->profundidade;
+    nodo_t *pai = caminho->nodos[k - 1];
+    int i = caminho->indices[k - 1];
+    int chave = i - 1;
+    if (i == 0) {
+        *_separadorEsquerdo(caminho) = pai->chaves[0];
+        chave = 0;
+    }
+    for (int c = chave; c < pai->numChaves - 1; c++) {
+        pai->chaves[c] = pai->chaves[c + 1];
+    }
+    for (int f = i; f < pai->numChaves; f++) {
+        pai->filhos[f] = pai->filhos[f + 1];
+    }
+    pai->filhos[pai->numChaves] = NULL;
+    pai->numChaves--;
+    free(caminho->nodos[k]);
+    arvore->numNodos--;
+    caminho->profundidade = k - 1;
+}
+
+// Enquanto o nó interno no fim do caminho tiver menos de MIN_FILHOS_INTERNO filhos, junta-o
+// a um vizinho do mesmo nível (ou redistribui os filhos dos dois, se não couberem em um
+// nó) e sobe para o pai que perdeu um filho. A raiz com um único filho é descartada.
+static void _corrigirInterno(BPlusTree_t *arvore, CaminhoNodo *caminho) {
+    while (1) {
+        int k = caminho->profundidade;
+        nodo_t *nodo = caminho->nodos[k];
+        if (k == 0) {
+            if (nodo->numChaves == 0) {
+                arvore->raiz = nodo->filhos[0];
+                free(nodo);
+                arvore->numNodos--;
+            } else {
+                _recontarCaminho(caminho, 0);
+            }
+            return;
+        }
+        if (nodo->numChaves + 1 >= MIN_FILHOS_INTERNO) {
+            _recontarCaminho(caminho, k);
+            return;
+        }
+
+        CaminhoNodo vizinho;
+        CaminhoNodo *esquerda = &vizinho, *direita = caminho;
+        if (_caminhoVizinho(caminho, -1, &vizinho) < 0) {
+            _caminhoVizinho(caminho, 1, &vizinho);
+            esquerda = caminho;
+            direita = &vizinho;
+        }
+        nodo_t *a = esquerda->nodos[k], *b = direita->nodos[k];
+        unsigned long long *separador = _separadorEsquerdo(direita);
+        unsigned long long chaves[2 * ORDEM];
+        nodo_t *filhos[2 * ORDEM];
+        int total = 0;
+        for (int i = 0; i <= a->numChaves; i++) {
+            filhos[total] = a->filhos[i];
+            chaves[total++] = i < a->numChaves ? a->chaves[i] : *separador;
+        }
+        for (int i = 0; i <= b->numChaves; i++) {
+            filhos[total] = b->filhos[i];
+            chaves[total++] = i < b->numChaves ? b->chaves[i] : 0;
+        }
+
+        // 'a' fica com os primeiros filhos; o separador entre os dois grupos vai para o ancestral
+        int numA = total <= ORDEM ? total : (total + 1) / 2;
+        for (int i = 0; i < ORDEM; i++) {
+            a->filhos[i] = i < numA ? filhos[i] : NULL;
+        }
+        for (int i = 0; i < numA - 1; i++) {
+            a->chaves[i] = chaves[i];
+        }
+        a->numChaves = numA - 1;
+        _recontarCaminho(esquerda, k);
+        if (numA == total) {
+            _removerDoPai(arvore, direita);
+            if (direita != caminho) {
+                *caminho = *direita;
+            }
+            continue;
+        }
+        *separador = chaves[numA - 1];
+        for (int i = 0; i < ORDEM; i++) {
+            b->filhos[i] = numA + i < total ? filhos[numA + i] : NULL;
+        }
+        for (int i = 0; numA + i < total - 1; i++) {
+            b->chaves[i] = chaves[numA + i];
+        }
+        b->numChaves = total - numA - 1;
+        _recontarCaminho(direita, k);
+        return;
+    }
+}
+
+// Cada passo desce uma vez até a folha da chave salva no estado e segue o encadeamento,
+// então pode ser intercalado com inserções. Cada folha com menos de 'alvo' chaves
+// absorve a seguinte inteira, se couber, ou recebe as primeiras chaves dela, mesmo que
+// a seguinte tenha outro pai: o separador corrigido é o do ancestral comum. Os pais que
+// perdem filhos são juntados aos vizinhos, até a raiz se preciso. Só os limites das
+// folhas importam para a ART, então ela é atualizada aqui e continua válida.
+int compactarFolhasPasso(BPlusTree_t *arvore, CompactadorFolhas_t *estado, int maxGrupos, int ocupacaoAlvo) {
+    if (arvore == NULL || estado->concluida) {
+        return 0;
+    }
+    // Com snapshots os nós podem estar compartilhados com versões antigas
+    if (arvore->numSnapshots > 0) {
+        return 0;
+    }
+    if (arvore->raiz->folha) {
+        estado->concluida = 1;
+        return 0;
+    }
+    int alvo = ((ORDEM - 1) * ocupacaoAlvo + 50) / 100;
+    if (alvo < 1) {
+        alvo = 1;
+    } else if (alvo > ORDEM - 1) {
+        alvo = ORDEM - 1;
+    }
+
+    int liberadas = 0;
+    CaminhoNodo caminho;
+    _descerAteFolha(arvore->raiz, estado->proximaChave, &caminho);
+    for (int passo = 0; passo < maxGrupos * ORDEM; passo++) {
+        int k = caminho.profundidade;
+        nodo_t *folha = caminho.nodos[k];
+        CaminhoNodo seguinte;
+        if (folha->proximo == NULL || _caminhoVizinho(&caminho, 1, &seguinte) < 0) {
+            estado->concluida = 1;
+            break;
+        }
+        nodo_t *direita = seguinte.nodos[k];
+
+        if (folha->numChaves + direita->numChaves <= alvo) {
+            for (int j = 0; j < direita->numChaves; j++) {
+                folha->chaves[folha->numChaves + j] = direita->chaves[j];
+                folha->registros[folha->numChaves + j] = direita->registros[j];
+            }
+            folha->numChaves += direita->numChaves;
+            folha->proximo = direita->proximo;
+            _recontarCaminho(&caminho, k - 1);
+            _retirarFolhaHibrido(arvore, *_separadorEsquerdo(&seguinte));
+            _removerDoPai(arvore, &seguinte);
+            _corrigirInterno(arvore, &seguinte);
+            liberadas++;
+            // Os nós internos do caminho podem ter sido juntados: desce de novo
+            _descerAteFolha(arvore->raiz, folha->chaves[0], &caminho);
+            continue;
+        }
+
+        int mover = alvo - folha->numChaves;
+        if (mover > 0) {
+            for (int j = 0; j < mover; j++) {
+                folha->chaves[folha->numChaves + j] = direita->chaves[j];
+                folha->registros[folha->numChaves + j] = direita->registros[j];
+            }
+            folha->numChaves += mover;
+            for (int j = mover; j < direita->numChaves; j++) {
+                direita->chaves[j - mover] = direita->chaves[j];
+                direita->registros[j - mover] = direita->registros[j];
+            }
+            direita->numChaves -= mover;
+            for (int j = direita->numChaves; j < ORDEM - 1; j++) {
+                direita->registros[j] = NULL;
+            }
+            unsigned long long *separador = _separadorEsquerdo(&seguinte);
+            _retirarFolhaHibrido(arvore, *separador);
+            *separador = direita->chaves[0];
+            _registrarFolhaHibrido(arvore, *separador, direita);
+            _recontarCaminho(&caminho, k - 1);
+            _recontarCaminho(&seguinte, k - 1);
+        }
+        caminho = seguinte;
+    }
+    nodo_t *atual = caminho.nodos[caminho.profundidade];
+    if (!estado->concluida && atual->numChaves > 0) {
+        estado->proximaChave = atual->chaves[0];
+    }
+    estado->folhasLiberadas += liberadas;
+    return liberadas;
+}
+
+// Recursivo como _contarNodos: a profundidade é a altura (no máximo ALTURA_MAXIMA) e,
+// como toda folha precisa ser lida, a recursão mede ~1,7x mais rápida que o percurso
+static void _estatisticasSubarvore(nodo_t *nodo, int nivel, EstatisticasArvore_t *estatisticas) {
+    estatisticas->numNodos++;
+    if (nodo->folha) {
+        estatisticas->numFolhas++;
+        estatisticas->numRegistros += nodo->numChaves;
+        estatisticas->altura = nivel + 1;
+        return;
+    }
+    for (int i = 0; i <= nodo->numChaves; i++) {
+        _estatisticasSubarvore(nodo->filhos[i], nivel + 1, estatisticas);
+    }
+}
+
+void estatisticasArvore(BPlusTree_t *arvore, EstatisticasArvore_t *estatisticas) {
+    memset(estatisticas, 0, sizeof(EstatisticasArvore_t));
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return;
+    }
+    _estatisticasSubarvore(arvore->raiz, 0, estatisticas);
+    estatisticas->ocupacaoFolhas = (double)estatisticas->numRegistros / (estatisticas->numFolhas * (ORDEM - 1));
+    estatisticas->memoria = estatisticas->numNodos * sizeof(nodo_t);
+}
+
+#if ESTATISTICAS_ORDEM
+// ====================================================================================
+// Estatísticas de Ordem (rank, seleção e contagem de intervalo)
+// ====================================================================================
+
+// Registros na subárvore: a folha conta suas chaves e o nó interno soma as contagens
+static long _totalSubarvore(nodo_t *nodo) {
+    if (nodo->folha) {
+        return nodo->numChaves;
+    }
+    long total = 0;
+    for (int i = 0; i <= nodo->numChaves; i++) {
+        total += nodo->contagens[i];
+    }
+    return total;
+}
+
+// Refaz as contagens do nó a partir dos filhos (que já devem estar corretos)
+static void _recalcularContagens(nodo_t *nodo) {
+    for (int i = 0; i < ORDEM; i++) {
+        nodo->contagens[i] = (i <= nodo->numChaves && nodo->filhos[i] != NULL) ? (unsigned int)_totalSubarvore(nodo->filhos[i]) : 0;
+    }
+}
+
+// Quantas chaves são menores que 'chave' (ou menores ou iguais, se 'inclusivo').
+// Desce pelo mesmo caminho de _buscarFolha somando as subárvores à esquerda.
+static long _contarAte(nodo_t *raiz, unsigned long long chave, int inclusivo) {
+    long antes = 0;
+    nodo_t *atual = raiz;
+    while (!atual->folha) {
+        int i = 0;
+        while (i < atual->numChaves && chave >= atual->chaves[i]) {
+            antes += atual->contagens[i];
+            i++;
+        }
+        atual = atual->filhos[i];
+    }
+    for (int i = 0; i < atual->numChaves && (atual->chaves[i] < chave || (inclusivo && atual->chaves[i] == chave)); i++) {
+        antes++;
+    }
+    return antes;
+}
+
+long totalRegistros(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return 0;
+    }
+    return _totalSubarvore(arvore->raiz);
+}
+
+long rank(BPlusTree_t *arvore, unsigned long long chave) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return 0;
+    }
+    return _contarAte(arvore->raiz, chave, 0);
+}
+
+long contarIntervalo(BPlusTree_t *arvore, unsigned long long a, unsigned long long b) {
+    if (arvore == NULL || arvore->raiz == NULL || a > b) {
+        return 0;
+    }
+    return _contarAte(arvore->raiz, b, 1) - _contarAte(arvore->raiz, a, 0);
+}
+
+registro_t *selecionar(BPlusTree_t *arvore, long k) {
+    if (arvore == NULL || arvore->raiz == NULL || k < 0) {
+        return NULL;
+    }
+    nodo_t *atual = arvore->raiz;
+    while (!atual->folha) {
+        int i = 0;
+        while (i < atual->numChaves && k >= (long)atual->contagens[i]) {
+            k -= atual->contagens[i];
+            i++;
+        }
+        atual = atual->filhos[i];
+    }
+    return k < atual->numChaves ? atual->registros[k] : NULL;
+}
+
+#endif // ESTATISTICAS_ORDEM
+
+// Achar altura da árvore B+
+int alturaArvoreBPlus(nodo_t *raiz) {
+    if (raiz == NULL) {
+        return 0;
+    }
+    int altura = 1;
+    nodo_t *atual = raiz;
+    while (!atual->folha) {
+        altura++;
+        atual = atual->filhos[0];
+    }
+    return altura;
+}
+
+// ====================================================================================
+// Funções de Impressão e Visualização (DOT)
+// ====================================================================================
+
+// Helper para imprimir o conteúdo de um nó
+static void _imprimeNodo(nodo_t *nodo) {
+    if (nodo->folha) {
+        printf("Folha: [");
+        for (int i = 0; i < nodo->numChaves; i++) {
+            printf("%llu (mod: %s)", nodo->chaves[i], registroModelo(nodo->registros[i]));
+            if (i < nodo->numChaves - 1) {
+                printf(", ");
+            }
+        }
+        printf("] -> (Prox: %p)\n", (void*)nodo->proximo);
+    } else {
+        printf("Interno: [");
+        for (int i = 0; i < nodo->numChaves; i++) {
+            printf("%llu", nodo->chaves[i]);
+            if (i < nodo->numChaves - 1) {
+                printf(", ");
+            }
+        }
+        printf("]\n");
+    }
+}
+
+// Imprime a árvore em pré-ordem, com a indentação dada pelo nível
+void imprimeArvore(nodo_t *nodo) {
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, nodo, PERCURSO_PROFUNDIDADE);
+    int nivel;
+    while ((nodo = proximoNodo(&percurso, &nivel)) != NULL) {
+        for (int j = 0; j < nivel * 4; j++) {
+            printf("  ");
+        }
+        _imprimeNodo(nodo);
+    }
+    encerrarPercurso(&percurso);
+}
+
+
+// Escreve a tabela de um nó e as arestas que saem dele
+static void _gerarDotNodo(nodo_t *nodo, FILE *f) {
+    // Etapa 1: Definir o nó atual usando sintaxe de tabela HTML
+    fprintf(f, "  node%p [shape=none, margin=0, label=<\n", (void*)nodo);
+    fprintf(f, "    <TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n");
+
+    // Linha 1: Células para os ponteiros de filhos
+    fprintf(f, "      <TR><TD PORT=\"f0\"> </TD>");
+    for (int i = 0; i < nodo->numChaves; i++) {
+        fprintf(f, "<TD PORT=\"f%d\"> </TD>", i + 1);
+    }
+    fprintf(f, "</TR>\n");
+
+    // Linha 2: Chaves e dados
+    fprintf(f, "      <TR>");
+    for (int i = 0; i < nodo->numChaves; i++) {
+        fprintf(f, "<TD BGCOLOR=\"%s\">%llu", nodo->folha ? "lightyellow" : "lightblue", nodo->chaves[i]);
+        if (nodo->folha && nodo->registros[i] != NULL) {
+            fprintf(f, "<BR/>%s<BR/>%d, %s",
+                    registroModelo(nodo->registros[i]),
+                    registroAno(nodo->registros[i]),
+                    registroCor(nodo->registros[i]));
+        }
+        fprintf(f, "</TD>");
+    }
+    // Adiciona uma célula vazia no final se for nó interno
+    if (nodo->numChaves > 0 || nodo->folha == 0) {
+        fprintf(f, "<TD BGCOLOR=\"%s\"> </TD>", nodo->folha ? "lightyellow" : "lightblue");
+    }
+    fprintf(f, "</TR>\n");
+
+    fprintf(f, "    </TABLE>>];\n");
+
+    // Etapa 2: Criar as arestas
+    if (!nodo->folha) {
+        for (int i = 0; i <= nodo->numChaves; i++) {
+            if (nodo->filhos[i] != NULL) {
+                fprintf(f, "  \"node%p\":f%d -> \"node%p\";\n", (void*)nodo, i, (void*)nodo->filhos[i]);
+            }
+        }
+    }
+    if (nodo->folha && nodo->proximo != NULL) {
+        fprintf(f, "  \"node%p\" -> \"node%p\" [style=dashed, color=gray, constraint=false];\n", (void*)nodo, (void*)nodo->proximo);
+    }
+}
+
+// Escreve todos os nós da subárvore (a ordem das declarações não importa para o Graphviz)
+void gerarDotConteudoHTML(nodo_t *nodo, FILE *f) {
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, nodo, PERCURSO_PROFUNDIDADE);
+    while ((nodo = proximoNodo(&percurso, NULL)) != NULL) {
+        _gerarDotNodo(nodo, f);
     }
+    encerrarPercurso(&percurso);
 }
 
 
@@ -5,6 +5,28 @@
 #define TAM_MODELO 20
 #define TAM_COR 20
 
+//modo de registro compacto (compilar com -DREGISTRO_COMPACTO=1)
+#ifndef REGISTRO_COMPACTO
+#define REGISTRO_COMPACTO 0
+#endif
+
+//estatísticas de ordem: contagem de registros por subárvore (compilar com -DESTATISTICAS_ORDEM=1)
+#ifndef ESTATISTICAS_ORDEM
+#define ESTATISTICAS_ORDEM 0
+#endif
+
+#if REGISTRO_COMPACTO
+#define ANO_BASE 1900 //anos são guardados como deslocamento a partir deste ano
+#define MAX_DICIONARIO 256 //máximo de modelos (e de cores) distintos
+
+//registro compacto: modelo e cor são códigos em dicionários compartilhados
+typedef struct {
+    unsigned long long chave; //chave única (renavam)
+    unsigned char modelo; //código do modelo no dicionário de modelos
+    unsigned char cor; //código da cor no dicionário de cores
+    unsigned char ano; //ano de fabricação - ANO_BASE
+} registro_t;
+#else
 //estrutura para armazenar os dados de um automóvel
 typedef struct {
     unsigned long long chave; //chave única (renavam)
@@ -12,33 +34,113 @@ typedef struct {
     int ano; //ano de fabricação
     char cor[TAM_COR]; //cor do veículo
 } registro_t;
+#endif
 
 //estrutura de um nó da árvore B+
 typedef struct nodo_t {
     unsigned long long chaves[ORDEM - 1]; //chaves armazenadas no nó
     struct nodo_t *filhos[ORDEM]; //ponteiros para os filhos
+#if ESTATISTICAS_ORDEM
+    unsigned int contagens[ORDEM]; //registros em cada subárvore filha (apenas nós internos)
+#endif
     registro_t *registros[ORDEM - 1]; //registros associados às chaves
     struct nodo_t *proximo; //ponteiro para o próximo nó
     unsigned short numChaves; //número de chaves atuais no nó
     char folha; //indica se o nó é folha (1) ou não (0) 
+    unsigned int referencias; //quantas versões (pais ou raízes) apontam para o nó
 } nodo_t;
 
 //estrutura da árvore B+
 typedef struct {
     nodo_t *raiz; //ponteiro para a raiz da árvore
-    int numNodos; //número total de nós na árvore
+    int numNodos; //número total de nós na árvore (use contarNodosArvore: pode estar desatualizado)
+    int nodosDesatualizados; //1 depois de dividirArvore: numNodos é recontado na próxima contarNodosArvore
+    int numSnapshots; //snapshots ativos; enquanto > 0 a inserção copia o caminho (copy-on-write)
+    long nodosVersoes; //nós mantidos apenas por versões antigas (memória extra dos snapshots)
+    struct FiltroBloom *filtro; //filtro de Bloom opcional das chaves (NULL = desativado)
+    struct IndiceHibrido *hibrido; //ART opcional que leva direto às folhas (NULL = desativado)
+    struct IndiceHash *hash; //tabela de espalhamento opcional chave -> registro (NULL = desativada)
 } BPlusTree_t;
 
-registro_t *criarRegistro(unsigned long long chave, const char *modelo, int ano, const char *cor);
+#define ALTURA_MAXIMA 64
+
+//estado da compactação incremental das folhas (iniciar com iniciarCompactacao)
+typedef struct {
+    unsigned long long proximaChave; //chave a partir da qual o próximo passo continua
+    int concluida; //1 depois que a última folha foi visitada
+    long folhasLiberadas; //folhas removidas desde o início
+} CompactadorFolhas_t;
+
+//resumo da ocupação da árvore
+typedef struct {
+    long numNodos; //nós internos e folhas
+    long numFolhas; //folhas
+    long numRegistros; //registros nas folhas
+    int altura; //níveis da raiz até as folhas
+    double ocupacaoFolhas; //fração das posições das folhas em uso
+    size_t memoria; //bytes ocupados pelos nós (sem os registros)
+} EstatisticasArvore_t;
+
+//visão consistente (somente leitura) da árvore em um instante
+typedef struct {
+    BPlusTree_t *arvore; //árvore de origem
+    nodo_t *raiz; //raiz da versão capturada
+} Snapshot_t;
+
+//cursor para percorrer as folhas de um snapshot sem usar o ponteiro 'proximo'
+typedef struct {
+    nodo_t *caminho[ALTURA_MAXIMA]; //nós da raiz até a folha atual
+    int indices[ALTURA_MAXIMA]; //índice do filho seguido em cada nível
+    int profundidade; //nível da folha atual
+} CursorSnapshot_t;
+
+registro_t *criarRegistro(unsigned long long chave, const char *modelo, int ano, const char *cor); //NULL se os dados não cabem no registro compacto
 void destruirRegistro(registro_t *registro); //protótipo de função para destruir um registro
+int atualizarRegistro(registro_t *registro, const char *modelo, int ano, const char *cor); //troca os dados mantendo a chave; 0 (sem alterar) se não cabem no registro compacto
+const char *registroModelo(const registro_t *registro); //modelo do veículo (decodificado no modo compacto)
+const char *registroCor(const registro_t *registro); //cor do veículo (decodificada no modo compacto)
+int registroAno(const registro_t *registro); //ano de fabricação
+int definirRegistroAno(registro_t *registro, int ano); //troca o ano; 0 (sem alterar) se não cabe no registro compacto
+#if REGISTRO_COMPACTO
+int codigoModelo(const char *modelo); //código do modelo no dicionário (-1 se ausente), para filtros sem strcmp
+int codigoCor(const char *cor); //código da cor no dicionário (-1 se ausente)
+void liberarPoolRegistros(void); //devolve ao sistema a memória dos registros (todos devem ter sido destruídos)
+#endif
 nodo_t *criarNodo(int folha); //protótipo de função para criar um novo nó (folha ou interno)
 void destruirNodo(nodo_t *nodo); //protótipo de função para destruir um nó
 BPlusTree_t *criarArvoreBPlus(); //protótipo de função para criar uma nova árvore B+
 void destruirArvoreBPlus(nodo_t *raiz); //protótipo de função para destruir a árvore B+
 void inserir(BPlusTree_t *arvore, registro_t *registro); //protótipo de função para inserir um registro na árvore B+
+void inserirLote(BPlusTree_t *arvore, registro_t **registros, int numRegistros); //insere vários registros descendo uma vez por nó (reordena o vetor)
 registro_t *buscar(BPlusTree_t *arvore, unsigned long long chave); //protótipo de função para buscar um registro na árvore B+
+void percorrerIntervalo(BPlusTree_t *arvore, unsigned long long inicio, unsigned long long fim, int (*visitar)(registro_t *registro, void *contexto), void *contexto); //visita em ordem as chaves em [inicio, fim] até 'visitar' devolver 0
+void ativarFiltroBloom(BPlusTree_t *arvore, int bitsPorChave); //cria o filtro com as chaves atuais; buscar() passa a consultá-lo antes de descer
+void desativarFiltroBloom(BPlusTree_t *arvore); //libera o filtro (chamar antes de liberar a árvore)
+void ativarIndiceHibrido(BPlusTree_t *arvore); //indexa as folhas atuais numa ART; buscar() e percorrerIntervalo() passam a pular os nós internos
+void desativarIndiceHibrido(BPlusTree_t *arvore); //libera a ART (chamar antes de liberar a árvore)
+void ativarIndiceHash(BPlusTree_t *arvore); //indexa todos os registros por chave; buscar() passa a consultar só a tabela
+void desativarIndiceHash(BPlusTree_t *arvore); //libera a tabela (chamar antes de liberar a árvore)
+BPlusTree_t *dividirArvore(BPlusTree_t *arvore, unsigned long long chave); //move as chaves >= 'chave' para uma árvore nova em O(altura); NULL com snapshots ativos
+int contarNodosArvore(BPlusTree_t *arvore); //numNodos, recontado (O(nós internos)) só se uma divisão o deixou desatualizado
+int unirArvores(BPlusTree_t *a, BPlusTree_t *b); //move os registros de 'b' para 'a' e libera 'b'; O(altura) se os intervalos forem disjuntos
+void iniciarCompactacao(CompactadorFolhas_t *estado); //prepara uma nova passada de compactação desde a menor chave
+int compactarFolhasPasso(BPlusTree_t *arvore, CompactadorFolhas_t *estado, int maxGrupos, int ocupacaoAlvo); //reempacota até 'maxGrupos' grupos de ORDEM folhas seguidas (mesmo de pais diferentes); retorna as folhas liberadas
+void estatisticasArvore(BPlusTree_t *arvore, EstatisticasArvore_t *estatisticas); //percorre a árvore e preenche o resumo de ocupação
 void imprimeArvore(nodo_t *nodo); //protótipo de função para imprimir a árvore B+ (para depuração).
 int alturaArvoreBPlus(nodo_t *raiz);
+#if ESTATISTICAS_ORDEM
+long totalRegistros(BPlusTree_t *arvore); //número de registros da árvore em O(ORDEM)
+long rank(BPlusTree_t *arvore, unsigned long long chave); //quantas chaves são menores que 'chave', em O(log n)
+long contarIntervalo(BPlusTree_t *arvore, unsigned long long a, unsigned long long b); //quantas chaves estão em [a, b], em O(log n)
+registro_t *selecionar(BPlusTree_t *arvore, long k); //k-ésimo registro na ordem das chaves (a partir de 0) ou NULL
+#endif
+
+//snapshots MVCC: devem ser liberados antes de destruir a árvore
+Snapshot_t *criarSnapshot(BPlusTree_t *arvore); //captura a versão atual em O(1)
+void liberarSnapshot(Snapshot_t *snapshot); //libera o snapshot e os nós que só ele referenciava
+registro_t *buscarSnapshot(Snapshot_t *snapshot, unsigned long long chave); //busca na versão capturada
+nodo_t *primeiraFolhaSnapshot(Snapshot_t *snapshot, CursorSnapshot_t *cursor); //primeira folha da versão capturada
+nodo_t *proximaFolhaSnapshot(CursorSnapshot_t *cursor); //próxima folha da versão capturada (NULL no fim)
 
 void gerarDot(BPlusTree_t *arvore, const char* nomeArquivo);
 
@@ -0,0 +1,380 @@
+// Modelo de árvore B+ especializada em tempo de compilação.
+//
+// Antes de incluir este arquivo, defina:
+//   AG_NOME          prefixo dos tipos e funções gerados (ex.: ArvoreU32)
+//   AG_CHAVE         tipo da chave recebida pelas funções (passada por valor)
+//   AG_VALOR         tipo do valor guardado nas folhas
+//   AG_ORDEM         número máximo de filhos de um nó interno
+//   AG_MENOR(a, b)   expressão verdadeira quando a < b
+// e, no arquivo .c que gera as funções, AG_IMPLEMENTACAO.
+//
+// Com isso as chaves ficam num vetor de AG_CHAVE dentro do nó. Para outro
+// armazenamento (ex.: chaves de tamanho variável), defina AG_CAMPO_CHAVES com o
+// campo 'chaves' do nó e, no lugar de AG_MENOR, as operações sobre ele:
+//   AG_MENOR_NO(nodo, i, chave)     chave i do nó < chave
+//   AG_MENOR_QUE_NO(chave, nodo, i) chave < chave i do nó
+//   AG_LER(nodo, i)                 chave i do nó como AG_CHAVE (vale até o nó mudar)
+//   AG_CABE(nodo, chave)            1 se a chave ainda cabe no nó
+//   AG_COLOCAR(nodo, pos, chave)    abre a posição 'pos' e grava a chave (numChaves é do modelo)
+//   AG_TRUNCAR(nodo, n)             descarta as chaves a partir da n-ésima
+//   AG_INICIAR_CHAVES(nodo)         prepara o campo de um nó novo
+//   AG_PESO(nodo, i)                peso da chave i ao escolher o ponto de divisão
+//   AG_PROMOVIDA                    tipo que guarda uma cópia da chave que sobe ao pai
+//   AG_PROMOVER(destino, chave)     copia a chave para um AG_PROMOVIDA
+//   AG_VISTA(promovida)             AG_CHAVE que lê a cópia
+//   AG_SEPARADOR(destino, esq, dir) separador entre duas folhas vizinhas, em AG_PROMOVIDA
+//   AG_VALIDA(chave)                0 se a chave não pode ser inserida
+//
+// São gerados AG_NOME_t, AG_NOMENodo_t e as funções criarAG_NOME, destruirAG_NOME,
+// inserirAG_NOME, buscarAG_NOME e percorrerAG_NOME. A árvore não é dona dos valores.
+// Pode ser incluído várias vezes, uma para cada especialização.
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define AG_CONCATENAR(a, b) a##b
+#define AG_JUNTAR(a, b) AG_CONCATENAR(a, b)
+#define AG_TIPO AG_JUNTAR(AG_NOME, _t)
+#define AG_NODO AG_JUNTAR(AG_NOME, Nodo_t)
+#define AG_NODO_STRUCT AG_JUNTAR(AG_NOME, Nodo)
+#define AG_SPLIT AG_JUNTAR(AG_NOME, Split_t)
+#define AG_FUNCAO(nome) AG_JUNTAR(nome, AG_NOME)
+
+// Chaves de tamanho fixo: vetor de AG_CHAVE comparado com AG_MENOR
+#ifndef AG_CAMPO_CHAVES
+#define AG_CAMPO_CHAVES AG_CHAVE chaves[AG_ORDEM - 1]
+#define AG_MENOR_NO(nodo, i, chave) AG_MENOR((nodo)->chaves[i], chave)
+#define AG_MENOR_QUE_NO(chave, nodo, i) AG_MENOR(chave, (nodo)->chaves[i])
+#define AG_LER(nodo, i) ((nodo)->chaves[i])
+#define AG_CABE(nodo, chave) ((nodo)->numChaves < AG_ORDEM - 1)
+#define AG_COLOCAR(nodo, pos, chave) AG_FUNCAO(_colocarChave)(nodo, pos, chave)
+#define AG_TRUNCAR(nodo, n) ((void)0)
+#define AG_INICIAR_CHAVES(nodo) ((void)0)
+#define AG_PESO(nodo, i) 1
+#define AG_PROMOVIDA AG_CHAVE
+#define AG_PROMOVER(destino, chave) (*(destino) = (chave))
+#define AG_VISTA(promovida) (promovida)
+#define AG_SEPARADOR(destino, esq, dir) (*(destino) = (dir))
+#define AG_VALIDA(chave) 1
+#define AG_CHAVES_FIXAS
+#endif
+
+//nó da árvore especializada: as folhas guardam valores, os nós internos, filhos
+typedef struct AG_NODO_STRUCT {
+    AG_CAMPO_CHAVES; //chaves armazenadas no nó
+    union {
+        struct AG_NODO_STRUCT *filhos[AG_ORDEM]; //ponteiros para os filhos (nó interno)
+        AG_VALOR valores[AG_ORDEM - 1]; //valores associados às chaves (folha)
+    };
+    struct AG_NODO_STRUCT *proximo; //próxima folha
+    unsigned short numChaves; //número de chaves atuais no nó
+    char folha; //indica se o nó é folha (1) ou não (0)
+} AG_NODO;
+
+//árvore especializada
+typedef struct {
+    AG_NODO *raiz; //ponteiro para a raiz da árvore
+    long numRegistros; //total de chaves armazenadas
+    int numNodos; //número total de nós na árvore
+} AG_TIPO;
+
+AG_TIPO *AG_FUNCAO(criar)(void);
+void AG_FUNCAO(destruir)(AG_TIPO *arvore); //libera os nós (não os valores)
+int AG_FUNCAO(inserir)(AG_TIPO *arvore, AG_CHAVE chave, AG_VALOR valor); //retorna 0 se a chave já existia ou é inválida
+AG_VALOR *AG_FUNCAO(buscar)(AG_TIPO *arvore, AG_CHAVE chave); //endereço do valor ou NULL
+//visita as chaves >= chave em ordem até a função retornar 0
+void AG_FUNCAO(percorrer)(AG_TIPO *arvore, AG_CHAVE chave, int (*visitar)(const AG_CHAVE *chave, AG_VALOR valor, void *contexto), void *contexto);
+
+#ifdef AG_IMPLEMENTACAO
+
+typedef struct {
+    AG_PROMOVIDA chave;
+    AG_NODO *novoNodo;
+    int ocorreuSplit;
+} AG_SPLIT;
+
+#ifdef AG_CHAVES_FIXAS
+static inline void AG_FUNCAO(_colocarChave)(AG_NODO *nodo, int pos, AG_CHAVE chave) {
+    for (int i = nodo->numChaves; i > pos; i--) {
+        nodo->chaves[i] = nodo->chaves[i - 1];
+    }
+    nodo->chaves[pos] = chave;
+}
+#endif
+
+static AG_NODO *AG_FUNCAO(_criarNodo)(int folha) {
+    AG_NODO *novoNodo = (AG_NODO *)malloc(sizeof(AG_NODO));
+    if (novoNodo == NULL) {
+        perror("Erro ao alocar nodo");
+        exit(EXIT_FAILURE);
+    }
+    novoNodo->numChaves = 0;
+    novoNodo->folha = folha;
+    novoNodo->proximo = NULL;
+    AG_INICIAR_CHAVES(novoNodo);
+    return novoNodo;
+}
+
+// Primeira posição cuja chave é >= chave (busca binária)
+static inline int AG_FUNCAO(_limiteInferior)(const AG_NODO *nodo, AG_CHAVE chave) {
+    int inicio = 0, fim = nodo->numChaves;
+    while (inicio < fim) {
+        int meio = (inicio + fim) / 2;
+        if (AG_MENOR_NO(nodo, meio, chave)) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio;
+}
+
+// Índice do filho que contém a chave: quantidade de separadores <= chave
+static inline int AG_FUNCAO(_indiceFilho)(const AG_NODO *nodo, AG_CHAVE chave) {
+    int inicio = 0, fim = nodo->numChaves;
+    while (inicio < fim) {
+        int meio = (inicio + fim) / 2;
+        if (AG_MENOR_QUE_NO(chave, nodo, meio)) {
+            fim = meio;
+        } else {
+            inicio = meio + 1;
+        }
+    }
+    return inicio;
+}
+
+// A posição vinda de _limiteInferior tem chave >= chave: é igual se não for maior
+static inline int AG_FUNCAO(_igual)(const AG_NODO *nodo, int pos, AG_CHAVE chave) {
+    return pos < nodo->numChaves && !AG_MENOR_QUE_NO(chave, nodo, pos);
+}
+
+AG_TIPO *AG_FUNCAO(criar)(void) {
+    AG_TIPO *arvore = (AG_TIPO *)malloc(sizeof(AG_TIPO));
+    if (arvore == NULL) {
+        perror("Erro ao alocar árvore");
+        exit(EXIT_FAILURE);
+    }
+    arvore->raiz = AG_FUNCAO(_criarNodo)(1);
+    arvore->numRegistros = 0;
+    arvore->numNodos = 1;
+    return arvore;
+}
+
+static void AG_FUNCAO(_destruirNodo)(AG_NODO *nodo) {
+    if (!nodo->folha) {
+        for (int i = 0; i <= nodo->numChaves; i++) {
+            AG_FUNCAO(_destruirNodo)(nodo->filhos[i]);
+        }
+    }
+    free(nodo);
+}
+
+void AG_FUNCAO(destruir)(AG_TIPO *arvore) {
+    if (arvore == NULL) {
+        return;
+    }
+    AG_FUNCAO(_destruirNodo)(arvore->raiz);
+    free(arvore);
+}
+
+static AG_NODO *AG_FUNCAO(_buscarFolha)(AG_NODO *raiz, AG_CHAVE chave) {
+    AG_NODO *atual = raiz;
+    while (!atual->folha) {
+        atual = atual->filhos[AG_FUNCAO(_indiceFilho)(atual, chave)];
+    }
+    return atual;
+}
+
+AG_VALOR *AG_FUNCAO(buscar)(AG_TIPO *arvore, AG_CHAVE chave) {
+    AG_NODO *folha = AG_FUNCAO(_buscarFolha)(arvore->raiz, chave);
+    int i = AG_FUNCAO(_limiteInferior)(folha, chave);
+    if (AG_FUNCAO(_igual)(folha, i, chave)) {
+        return &folha->valores[i];
+    }
+    return NULL;
+}
+
+void AG_FUNCAO(percorrer)(AG_TIPO *arvore, AG_CHAVE chave, int (*visitar)(const AG_CHAVE *chave, AG_VALOR valor, void *contexto), void *contexto) {
+    AG_NODO *folha = AG_FUNCAO(_buscarFolha)(arvore->raiz, chave);
+    int i = AG_FUNCAO(_limiteInferior)(folha, chave);
+    while (folha != NULL) {
+        for (; i < folha->numChaves; i++) {
+            AG_CHAVE atual = AG_LER(folha, i);
+            if (!visitar(&atual, folha->valores[i], contexto)) {
+                return;
+            }
+        }
+        folha = folha->proximo;
+        i = 0;
+    }
+}
+
+// Número de chaves que ficam à esquerda na divisão: o ponto em que o peso acumulado
+// atinge metade do total, entre 'minimo' e 'maximo'
+static int AG_FUNCAO(_pontoDivisao)(const AG_NODO *nodo, int minimo, int maximo) {
+    int total = 0;
+    for (int i = 0; i < nodo->numChaves; i++) {
+        total += AG_PESO(nodo, i);
+    }
+    int acumulado = 0, ponto = maximo;
+    for (int i = 0; i < nodo->numChaves; i++) {
+        acumulado += AG_PESO(nodo, i);
+        if (acumulado * 2 >= total) {
+            ponto = i + 1;
+            break;
+        }
+    }
+    if (ponto < minimo) ponto = minimo;
+    if (ponto > maximo) ponto = maximo;
+    return ponto;
+}
+
+// Passa as chaves a partir de 'inicio' (com os valores ou os filhos à direita delas)
+// para o fim do nó 'destino'
+static void AG_FUNCAO(_moverChaves)(AG_NODO *origem, int inicio, AG_NODO *destino) {
+    for (int i = inicio; i < origem->numChaves; i++) {
+        if (origem->folha) {
+            destino->valores[destino->numChaves] = origem->valores[i];
+        } else {
+            destino->filhos[destino->numChaves + 1] = origem->filhos[i + 1];
+        }
+        AG_COLOCAR(destino, destino->numChaves, AG_LER(origem, i));
+        destino->numChaves++;
+    }
+}
+
+static void AG_FUNCAO(_inserirNaFolha)(AG_NODO *nodo, int pos, AG_CHAVE chave, AG_VALOR valor) {
+    for (int i = nodo->numChaves; i > pos; i--) {
+        nodo->valores[i] = nodo->valores[i - 1];
+    }
+    nodo->valores[pos] = valor;
+    AG_COLOCAR(nodo, pos, chave);
+    nodo->numChaves++;
+}
+
+// Coloca o separador na posição 'pos' e o filho à direita dele em pos + 1
+static void AG_FUNCAO(_inserirNoInterno)(AG_NODO *nodo, int pos, AG_CHAVE chave, AG_NODO *filho) {
+    for (int i = nodo->numChaves; i > pos; i--) {
+        nodo->filhos[i + 1] = nodo->filhos[i];
+    }
+    nodo->filhos[pos + 1] = filho;
+    AG_COLOCAR(nodo, pos, chave);
+    nodo->numChaves++;
+}
+
+// Insere na subárvore e devolve a chave e o nó promovidos quando há divisão. Um nó
+// cheio é dividido antes, e a chave entra na metade que a contém.
+static AG_SPLIT AG_FUNCAO(_inserirRecursivo)(AG_TIPO *arvore, AG_NODO *nodo, AG_CHAVE chave, AG_VALOR valor, int *inserido) {
+    AG_SPLIT resultado;
+    resultado.ocorreuSplit = 0;
+
+    if (nodo->folha) {
+        int pos = AG_FUNCAO(_limiteInferior)(nodo, chave);
+        if (AG_FUNCAO(_igual)(nodo, pos, chave)) {
+            *inserido = 0;
+            return resultado;
+        }
+        *inserido = 1;
+        if (AG_CABE(nodo, chave)) {
+            AG_FUNCAO(_inserirNaFolha)(nodo, pos, chave, valor);
+            return resultado;
+        }
+
+        // Folha cheia: metade do peso vai para a nova folha à direita
+        AG_NODO *novo = AG_FUNCAO(_criarNodo)(1);
+        arvore->numNodos++;
+        int ponto = AG_FUNCAO(_pontoDivisao)(nodo, 1, nodo->numChaves - 1);
+        AG_FUNCAO(_moverChaves)(nodo, ponto, novo);
+        AG_TRUNCAR(nodo, ponto);
+        nodo->numChaves = ponto;
+        novo->proximo = nodo->proximo;
+        nodo->proximo = novo;
+        if (pos <= ponto) {
+            AG_FUNCAO(_inserirNaFolha)(nodo, pos, chave, valor);
+        } else {
+            AG_FUNCAO(_inserirNaFolha)(novo, pos - ponto, chave, valor);
+        }
+
+        AG_SEPARADOR(&resultado.chave, AG_LER(nodo, nodo->numChaves - 1), AG_LER(novo, 0));
+        resultado.novoNodo = novo;
+        resultado.ocorreuSplit = 1;
+        return resultado;
+    }
+
+    int indiceFilho = AG_FUNCAO(_indiceFilho)(nodo, chave);
+    AG_SPLIT split = AG_FUNCAO(_inserirRecursivo)(arvore, nodo->filhos[indiceFilho], chave, valor, inserido);
+    if (!split.ocorreuSplit) {
+        return resultado;
+    }
+    if (AG_CABE(nodo, AG_VISTA(split.chave))) {
+        AG_FUNCAO(_inserirNoInterno)(nodo, indiceFilho, AG_VISTA(split.chave), split.novoNodo);
+        return resultado;
+    }
+
+    // Nó interno cheio: a chave do ponto de divisão sobe para o pai e as seguintes
+    // (com os filhos à direita delas) vão para o novo nó
+    AG_NODO *novo = AG_FUNCAO(_criarNodo)(0);
+    arvore->numNodos++;
+    int ponto = AG_FUNCAO(_pontoDivisao)(nodo, 1, nodo->numChaves - 2);
+    AG_PROMOVER(&resultado.chave, AG_LER(nodo, ponto));
+    novo->filhos[0] = nodo->filhos[ponto + 1];
+    AG_FUNCAO(_moverChaves)(nodo, ponto + 1, novo);
+    AG_TRUNCAR(nodo, ponto);
+    nodo->numChaves = ponto;
+    if (indiceFilho <= ponto) {
+        AG_FUNCAO(_inserirNoInterno)(nodo, indiceFilho, AG_VISTA(split.chave), split.novoNodo);
+    } else {
+        AG_FUNCAO(_inserirNoInterno)(novo, indiceFilho - ponto - 1, AG_VISTA(split.chave), split.novoNodo);
+    }
+
+    resultado.novoNodo = novo;
+    resultado.ocorreuSplit = 1;
+    return resultado;
+}
+
+int AG_FUNCAO(inserir)(AG_TIPO *arvore, AG_CHAVE chave, AG_VALOR valor) {
+    if (!AG_VALIDA(chave)) {
+        return 0;
+    }
+    int inserido = 0;
+    AG_SPLIT split = AG_FUNCAO(_inserirRecursivo)(arvore, arvore->raiz, chave, valor, &inserido);
+    if (split.ocorreuSplit) {
+        AG_NODO *novaRaiz = AG_FUNCAO(_criarNodo)(0);
+        arvore->numNodos++;
+        novaRaiz->filhos[0] = arvore->raiz;
+        AG_FUNCAO(_inserirNoInterno)(novaRaiz, 0, AG_VISTA(split.chave), split.novoNodo);
+        arvore->raiz = novaRaiz;
+    }
+    arvore->numRegistros += inserido;
+    return inserido;
+}
+
+#endif // AG_IMPLEMENTACAO
+
+#undef AG_CONCATENAR
+#undef AG_JUNTAR
+#undef AG_TIPO
+#undef AG_NODO
+#undef AG_NODO_STRUCT
+#undef AG_SPLIT
+#undef AG_FUNCAO
+#undef AG_NOME
+#undef AG_CHAVE
+#undef AG_VALOR
+#undef AG_ORDEM
+#undef AG_MENOR
+#undef AG_CAMPO_CHAVES
+#undef AG_MENOR_NO
+#undef AG_MENOR_QUE_NO
+#undef AG_LER
+#undef AG_CABE
+#undef AG_COLOCAR
+#undef AG_TRUNCAR
+#undef AG_INICIAR_CHAVES
+#undef AG_PESO
+#undef AG_PROMOVIDA
+#undef AG_PROMOVER
+#undef AG_VISTA
+#undef AG_SEPARADOR
+#undef AG_VALIDA
+#undef AG_CHAVES_FIXAS
@@ -0,0 +1,2 @@
+#define AG_IMPLEMENTACAO
+#include "arvore_string.h"
@@ -0,0 +1,173 @@
+// Árvore B+ com chaves de tamanho variável (ex.: placas), gerada pelo mesmo modelo
+// das especializações de chave fixa (arvore_generica.h). As chaves ficam num layout
+// de slots: a área de dados do nó guarda os bytes e cada slot traz os 4 primeiros em
+// big-endian, que decidem a maior parte das comparações sem ler a área de dados.
+// arvore_string.c inclui este arquivo com AG_IMPLEMENTACAO definido para gerar as
+// funções; nos demais arquivos só as declarações são geradas.
+#ifndef ARVORE_STRING_TIPOS
+#define ARVORE_STRING_TIPOS
+
+#include <stdio.h>
+#include <string.h>
+
+#define TAM_DADOS_STRING 2048 //bytes reservados para as chaves de cada nó
+#define MAX_CHAVES_STRING 64 //número máximo de chaves por nó
+#define TAM_MAX_CHAVE_STRING 255 //tamanho máximo de uma chave
+
+//entrada do diretório de slots: aponta para a chave dentro da área de dados do nó
+typedef struct {
+    unsigned int cabeca; //primeiros 4 bytes da chave em big-endian (comparação rápida)
+    unsigned short deslocamento; //início da chave em 'dados'
+    unsigned short tamanho; //tamanho da chave em bytes
+} SlotString_t;
+
+//chaves de um nó em layout de slots
+typedef struct {
+    SlotString_t slots[MAX_CHAVES_STRING]; //slots ordenados pela chave
+    unsigned short usado; //bytes ocupados em 'dados'
+    char dados[TAM_DADOS_STRING]; //bytes das chaves, referenciados pelos slots
+} ChavesString_t;
+
+//chave recebida pela árvore: os bytes não são copiados (use chaveString para montá-la)
+typedef struct {
+    const char *bytes; //bytes da chave (sem terminador)
+    int tamanho; //tamanho da chave em bytes
+    unsigned int cabeca; //primeiros 4 bytes em big-endian, completados com zero
+} ChaveString_t;
+
+// Primeiros 4 bytes da chave em big-endian; chaves curtas são completadas com zero
+static inline unsigned int cabecaString(const char *bytes, int tamanho) {
+    unsigned int cabeca = 0;
+    for (int i = 0; i < 4; i++) {
+        cabeca = (cabeca << 8) | (i < tamanho ? (unsigned char)bytes[i] : 0);
+    }
+    return cabeca;
+}
+
+static inline ChaveString_t chaveString(const char *texto) {
+    ChaveString_t chave;
+    chave.bytes = texto;
+    chave.tamanho = (int)strlen(texto);
+    chave.cabeca = cabecaString(texto, chave.tamanho);
+    return chave;
+}
+
+#ifdef AG_IMPLEMENTACAO
+
+//cópia de uma chave que sobe para o pai numa divisão
+typedef struct {
+    char bytes[TAM_MAX_CHAVE_STRING];
+    int tamanho;
+} ChavePromovidaString_t;
+
+// Compara a chave do slot i com a chave informada (<0, 0 ou >0). A maior parte das
+// comparações é decidida pela cabeça, sem acessar a área de dados do nó.
+static inline int _compararString(const ChavesString_t *chaves, int i, ChaveString_t chave) {
+    const SlotString_t *slot = &chaves->slots[i];
+    if (slot->cabeca != chave.cabeca) {
+        return slot->cabeca < chave.cabeca ? -1 : 1;
+    }
+    int menor = slot->tamanho < chave.tamanho ? slot->tamanho : chave.tamanho;
+    if (menor > 4) {
+        int resultado = memcmp(chaves->dados + slot->deslocamento + 4, chave.bytes + 4, menor - 4);
+        if (resultado != 0) {
+            return resultado;
+        }
+    }
+    return slot->tamanho - chave.tamanho;
+}
+
+static inline ChaveString_t _lerString(const ChavesString_t *chaves, int i) {
+    ChaveString_t chave;
+    chave.bytes = chaves->dados + chaves->slots[i].deslocamento;
+    chave.tamanho = chaves->slots[i].tamanho;
+    chave.cabeca = chaves->slots[i].cabeca;
+    return chave;
+}
+
+static inline int _cabeString(const ChavesString_t *chaves, int numChaves, ChaveString_t chave) {
+    return numChaves < MAX_CHAVES_STRING && chaves->usado + chave.tamanho <= TAM_DADOS_STRING;
+}
+
+// Abre espaço no slot 'pos' e copia a chave para o fim da área de dados
+static inline void _colocarString(ChavesString_t *chaves, int numChaves, int pos, ChaveString_t chave) {
+    memmove(&chaves->slots[pos + 1], &chaves->slots[pos], (numChaves - pos) * sizeof(SlotString_t));
+    memcpy(chaves->dados + chaves->usado, chave.bytes, chave.tamanho);
+    chaves->slots[pos].cabeca = chave.cabeca;
+    chaves->slots[pos].deslocamento = chaves->usado;
+    chaves->slots[pos].tamanho = chave.tamanho;
+    chaves->usado += chave.tamanho;
+}
+
+// Mantém as n primeiras chaves e compacta a área de dados, que fica com buracos das
+// chaves que foram para o outro nó
+static inline void _truncarString(ChavesString_t *chaves, int n) {
+    char copia[TAM_DADOS_STRING];
+    memcpy(copia, chaves->dados, chaves->usado);
+    chaves->usado = 0;
+    for (int i = 0; i < n; i++) {
+        memcpy(chaves->dados + chaves->usado, copia + chaves->slots[i].deslocamento, chaves->slots[i].tamanho);
+        chaves->slots[i].deslocamento = chaves->usado;
+        chaves->usado += chaves->slots[i].tamanho;
+    }
+}
+
+static inline void _promoverString(ChavePromovidaString_t *destino, ChaveString_t chave, int tamanho) {
+    memcpy(destino->bytes, chave.bytes, tamanho);
+    destino->tamanho = tamanho;
+}
+
+// Separador mais curto que ainda distingue as duas folhas: o prefixo comum mais um byte
+static inline void _separadorString(ChavePromovidaString_t *destino, ChaveString_t esquerda, ChaveString_t direita) {
+    int comum = 0;
+    while (comum < esquerda.tamanho && comum < direita.tamanho && esquerda.bytes[comum] == direita.bytes[comum]) {
+        comum++;
+    }
+    _promoverString(destino, direita, comum + 1);
+}
+
+static inline ChaveString_t _vistaString(const ChavePromovidaString_t *promovida) {
+    ChaveString_t chave;
+    chave.bytes = promovida->bytes;
+    chave.tamanho = promovida->tamanho;
+    chave.cabeca = cabecaString(promovida->bytes, promovida->tamanho);
+    return chave;
+}
+
+static inline int _validaString(ChaveString_t chave) {
+    if (chave.tamanho > TAM_MAX_CHAVE_STRING) {
+        fprintf(stderr, "Chave com mais de %d bytes. Inserção ignorada.\n", TAM_MAX_CHAVE_STRING);
+        return 0;
+    }
+    return 1;
+}
+
+#endif // AG_IMPLEMENTACAO
+
+#endif // ARVORE_STRING_TIPOS
+
+#if !defined(ARVORE_STRING_H) || defined(AG_IMPLEMENTACAO)
+#define ARVORE_STRING_H
+
+//folhas e nós internos dividem pelo volume de bytes, não pelo número de chaves
+#define AG_NOME ArvoreString
+#define AG_CHAVE ChaveString_t
+#define AG_VALOR void *
+#define AG_ORDEM (MAX_CHAVES_STRING + 1)
+#define AG_CAMPO_CHAVES ChavesString_t chaves
+#define AG_MENOR_NO(nodo, i, chave) (_compararString(&(nodo)->chaves, i, chave) < 0)
+#define AG_MENOR_QUE_NO(chave, nodo, i) (_compararString(&(nodo)->chaves, i, chave) > 0)
+#define AG_LER(nodo, i) _lerString(&(nodo)->chaves, i)
+#define AG_CABE(nodo, chave) _cabeString(&(nodo)->chaves, (nodo)->numChaves, chave)
+#define AG_COLOCAR(nodo, pos, chave) _colocarString(&(nodo)->chaves, (nodo)->numChaves, pos, chave)
+#define AG_TRUNCAR(nodo, n) _truncarString(&(nodo)->chaves, n)
+#define AG_INICIAR_CHAVES(nodo) ((nodo)->chaves.usado = 0)
+#define AG_PESO(nodo, i) ((nodo)->chaves.slots[i].tamanho)
+#define AG_PROMOVIDA ChavePromovidaString_t
+#define AG_PROMOVER(destino, chave) _promoverString(destino, chave, (chave).tamanho)
+#define AG_VISTA(promovida) _vistaString(&(promovida))
+#define AG_SEPARADOR(destino, esq, dir) _separadorString(destino, esq, dir)
+#define AG_VALIDA(chave) _validaString(chave)
+#include "arvore_generica.h"
+
+#endif // ARVORE_STRING_H
@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "bloom.h"
+
+#define TAM_LINHA_CACHE 64
+#define MAX_HASHES 16
+
+// Mistura os bits da chave (finalizador do splitmix64); chaves sequenciais
+// de renavam ficam espalhadas pelos blocos
+static unsigned long long _misturar(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Os 32 bits altos escolhem o bloco (multiplicação em vez de módulo) e os baixos
+// geram as posições dentro dele por hashing duplo
+static BlocoBloom_t *_obterBloco(const FiltroBloom_t *filtro, unsigned long long hash) {
+    return &filtro->blocos[((hash >> 32) * filtro->numBlocos) >> 32];
+}
+
+FiltroBloom_t *criarFiltroBloom(long capacidade, int bitsPorChave) {
+    if (capacidade < 1) {
+        capacidade = 1;
+    }
+    if (bitsPorChave < 1) {
+        bitsPorChave = BITS_POR_CHAVE_PADRAO;
+    }
+    FiltroBloom_t *filtro = (FiltroBloom_t *)malloc(sizeof(FiltroBloom_t));
+    if (filtro == NULL) {
+        perror("Erro ao alocar filtro de Bloom");
+        exit(EXIT_FAILURE);
+    }
+    filtro->numBlocos = (unsigned long)((capacidade * (long)bitsPorChave + BITS_BLOCO_BLOOM - 1) / BITS_BLOCO_BLOOM);
+    filtro->bitsPorChave = bitsPorChave;
+    filtro->capacidade = capacidade;
+    filtro->numElementos = 0;
+    // k ótimo = bits por chave * ln 2
+    filtro->numHashes = (int)(bitsPorChave * 0.69 + 0.5);
+    if (filtro->numHashes < 1) {
+        filtro->numHashes = 1;
+    } else if (filtro->numHashes > MAX_HASHES) {
+        filtro->numHashes = MAX_HASHES;
+    }
+    filtro->blocos = (BlocoBloom_t *)aligned_alloc(TAM_LINHA_CACHE, filtro->numBlocos * sizeof(BlocoBloom_t));
+    if (filtro->blocos == NULL) {
+        perror("Erro ao alocar blocos do filtro de Bloom");
+        exit(EXIT_FAILURE);
+    }
+    memset(filtro->blocos, 0, filtro->numBlocos * sizeof(BlocoBloom_t));
+    return filtro;
+}
+
+void destruirFiltroBloom(FiltroBloom_t *filtro) {
+    if (filtro == NULL) {
+        return;
+    }
+    free(filtro->blocos);
+    free(filtro);
+}
+
+void adicionarFiltroBloom(FiltroBloom_t *filtro, unsigned long long chave) {
+    unsigned long long hash = _misturar(chave);
+    BlocoBloom_t *bloco = _obterBloco(filtro, hash);
+    unsigned int posicao = (unsigned int)hash;
+    unsigned int passo = (unsigned int)(hash >> 9) | 1;
+    for (int i = 0; i < filtro->numHashes; i++, posicao += passo) {
+        unsigned int bit = posicao % BITS_BLOCO_BLOOM;
+        bloco->palavras[bit / 64] |= 1ULL << (bit % 64);
+    }
+    filtro->numElementos++;
+}
+
+int consultarFiltroBloom(const FiltroBloom_t *filtro, unsigned long long chave) {
+    unsigned long long hash = _misturar(chave);
+    const BlocoBloom_t *bloco = _obterBloco(filtro, hash);
+    unsigned int posicao = (unsigned int)hash;
+    unsigned int passo = (unsigned int)(hash >> 9) | 1;
+    for (int i = 0; i < filtro->numHashes; i++, posicao += passo) {
+        unsigned int bit = posicao % BITS_BLOCO_BLOOM;
+        if (!(bloco->palavras[bit / 64] & (1ULL << (bit % 64)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+FiltroBloom_t *copiarFiltroBloom(const FiltroBloom_t *filtro) {
+    FiltroBloom_t *copia = criarFiltroBloom(filtro->capacidade, filtro->bitsPorChave);
+    memcpy(copia->blocos, filtro->blocos, filtro->numBlocos * sizeof(BlocoBloom_t));
+    copia->numElementos = filtro->numElementos;
+    return copia;
+}
@@ -0,0 +1,29 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#define BITS_BLOCO_BLOOM 512 //cada bloco ocupa exatamente uma linha de cache
+#define BITS_POR_CHAVE_PADRAO 10 //~1% de falsos positivos
+
+// Bloco de 512 bits: todos os bits de uma chave caem no mesmo bloco,
+// então uma consulta toca uma única linha de cache.
+typedef struct {
+    unsigned long long palavras[BITS_BLOCO_BLOOM / 64];
+} BlocoBloom_t;
+
+// Filtro de Bloom em blocos (blocked Bloom filter) sobre chaves de 64 bits
+typedef struct FiltroBloom {
+    BlocoBloom_t *blocos; //vetor alinhado à linha de cache
+    unsigned long numBlocos; //quantidade de blocos
+    int numHashes; //bits marcados por chave
+    int bitsPorChave; //orçamento de bits por chave usado no dimensionamento
+    long capacidade; //chaves previstas no dimensionamento
+    long numElementos; //chaves adicionadas
+} FiltroBloom_t;
+
+FiltroBloom_t *criarFiltroBloom(long capacidade, int bitsPorChave); //filtro para 'capacidade' chaves
+void destruirFiltroBloom(FiltroBloom_t *filtro);
+void adicionarFiltroBloom(FiltroBloom_t *filtro, unsigned long long chave);
+int consultarFiltroBloom(const FiltroBloom_t *filtro, unsigned long long chave); //0 = chave certamente ausente
+FiltroBloom_t *copiarFiltroBloom(const FiltroBloom_t *filtro); //cópia independente do filtro
+
+#endif // BLOOM_H
@@ -0,0 +1,304 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "carga.h"
+
+#define AMPLITUDE_RENAVAM (RENAVAM_MAX - RENAVAM_MIN + 1)
+#define LIMITE_INDICES (AMPLITUDE_RENAVAM / 2) //índices acima deste ficam reservados para chaves ausentes
+#define BITS_METADE 19 //a permutação atua sobre 38 bits (2^38 > AMPLITUDE_RENAVAM)
+#define MASCARA_METADE ((1ULL << BITS_METADE) - 1)
+#define RODADAS_FEISTEL 4
+#define ZIPF_TERMOS_EXATOS 1000 //termos de zeta(n) somados um a um; o resto é aproximado pela integral
+#define TAM_LOTE_CARGA 65536
+#define ANO_INICIAL 1995
+#define NUM_ANOS 30
+
+static const char *modelos[] = {"Gol", "Onix", "Corolla", "Civic", "HB20", "Fiesta", "Ka", "Sandero", "Compass", "Polo"};
+static const char *cores[] = {"Preto", "Branco", "Prata", "Vermelho", "Azul", "Cinza", "Verde"};
+
+// Misturas do YCSB. Como a árvore não tem atualização cega, a atualização de A e a
+// leitura-modificação-escrita de F são a mesma operação (busca e altera o registro).
+static const MisturaOperacoes_t misturas[] = {
+    {"A (atualizações frequentes)", {50, 50, 0, 0, 0}, DIST_ZIPF, 0},
+    {"B (leitura predominante)", {95, 5, 0, 0, 0}, DIST_ZIPF, 0},
+    {"C (somente leitura)", {100, 0, 0, 0, 0}, DIST_ZIPF, 0},
+    {"D (leitura dos recentes)", {95, 0, 5, 0, 0}, DIST_RECENTES, 0},
+    {"E (varreduras curtas)", {0, 0, 5, 95, 0}, DIST_ZIPF, 100},
+    {"F (leitura-modificação-escrita)", {50, 50, 0, 0, 0}, DIST_ZIPF, 0},
+};
+
+// ====================================================================================
+// Gerador Pseudoaleatório
+// ====================================================================================
+
+// Finalizador do splitmix64: espalha os bits de um valor de 64 bits
+static unsigned long long _misturar(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void semearGerador(GeradorAleatorio_t *gerador, unsigned long long semente) {
+    gerador->estado = _misturar(semente);
+    if (gerador->estado == 0) {
+        gerador->estado = 1; // o xorshift não sai do zero
+    }
+}
+
+unsigned long long proximoAleatorio(GeradorAleatorio_t *gerador) {
+    unsigned long long x = gerador->estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    gerador->estado = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+unsigned long long aleatorioAte(GeradorAleatorio_t *gerador, unsigned long long limite) {
+    return limite > 0 ? proximoAleatorio(gerador) % limite : 0;
+}
+
+double aleatorioReal(GeradorAleatorio_t *gerador) {
+    return (proximoAleatorio(gerador) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// ====================================================================================
+// Chaves Únicas (permutação de Feistel)
+// ====================================================================================
+
+static unsigned long long _feistel(const Carga_t *carga, unsigned long long x) {
+    unsigned long long esquerda = x >> BITS_METADE, direita = x & MASCARA_METADE;
+    for (int r = 0; r < RODADAS_FEISTEL; r++) {
+        unsigned long long nova = esquerda ^ (_misturar(direita ^ carga->chavesFeistel[r]) & MASCARA_METADE);
+        esquerda = direita;
+        direita = nova;
+    }
+    return (esquerda << BITS_METADE) | direita;
+}
+
+// Permutação de [0, AMPLITUDE_RENAVAM): a rede de Feistel embaralha 38 bits e os
+// valores fora do intervalo são permutados de novo até cair nele (cycle walking).
+// Índices distintos geram chaves distintas sem guardar as já usadas.
+static unsigned long long _permutar(const Carga_t *carga, unsigned long long indice) {
+    unsigned long long x = indice;
+    do {
+        x = _feistel(carga, x);
+    } while (x >= AMPLITUDE_RENAVAM);
+    return x;
+}
+
+unsigned long long chaveDoIndice(const Carga_t *carga, long indice) {
+    if (carga->disposicao == DIST_SEQUENCIAL) {
+        return RENAVAM_MIN + (unsigned long long)indice;
+    }
+    return RENAVAM_MIN + _permutar(carga, (unsigned long long)indice);
+}
+
+// ====================================================================================
+// Distribuição de Zipf (mesmo método do YCSB, Gray et al.)
+// ====================================================================================
+
+// zeta(n) = soma de 1/i^teta para i = 1..n. Os primeiros termos são somados e o
+// restante vem da aproximação de Euler-Maclaurin, para n chegar a 10^8 em O(1).
+// A parte exata fica guardada na carga e só ganha os termos novos quando n cresce
+// (como o YCSB faz com zeta inteira), então mudar n não refaz as potências.
+static double _zeta(Carga_t *carga, long n, double teta) {
+    long exatos = n < ZIPF_TERMOS_EXATOS ? n : ZIPF_TERMOS_EXATOS;
+    if (exatos < carga->zipfExatos) {
+        carga->zipfExatos = 0;
+        carga->zipfSomaExata = 0;
+    }
+    for (long i = carga->zipfExatos + 1; i <= exatos; i++) {
+        carga->zipfSomaExata += 1.0 / pow((double)i, teta);
+    }
+    carga->zipfExatos = exatos;
+    double soma = carga->zipfSomaExata;
+    if (n > exatos) {
+        soma += (pow((double)n, 1 - teta) - pow((double)exatos, 1 - teta)) / (1 - teta);
+        soma += 0.5 * (pow((double)n, -teta) - pow((double)exatos, -teta));
+    }
+    return soma;
+}
+
+// Posição (0 = mais popular) entre 'n' itens
+static long _sortearZipf(Carga_t *carga, long n) {
+    if (carga->zipfN != n) {
+        // Inserções mudam 'n': zeta(n) e eta são atualizadas em O(1) amortizado
+        carga->zipfN = n;
+        carga->zipfZetaN = _zeta(carga, n, ZIPF_TETA);
+        carga->zipfEta = (1 - pow(2.0 / n, 1 - ZIPF_TETA)) / (1 - carga->zipfZeta2 / carga->zipfZetaN);
+    }
+    double u = aleatorioReal(&carga->gerador);
+    double uz = u * carga->zipfZetaN;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < carga->zipfZeta2) {
+        return n > 1 ? 1 : 0;
+    }
+    long posicao = (long)(n * pow(carga->zipfEta * u - carga->zipfEta + 1, carga->zipfAlfa));
+    return posicao < n ? posicao : n - 1;
+}
+
+// ====================================================================================
+// Registros e Operações
+// ====================================================================================
+
+Carga_t *criarCarga(unsigned long long semente, Distribuicao disposicao) {
+    Carga_t *carga = (Carga_t *)malloc(sizeof(Carga_t));
+    if (carga == NULL) {
+        perror("Erro ao alocar gerador de carga");
+        exit(EXIT_FAILURE);
+    }
+    semearGerador(&carga->gerador, semente);
+    carga->disposicao = disposicao;
+    for (int r = 0; r < RODADAS_FEISTEL; r++) {
+        carga->chavesFeistel[r] = proximoAleatorio(&carga->gerador);
+    }
+    carga->numRegistros = 0;
+    carga->proximoSequencial = 0;
+    carga->zipfN = 0;
+    carga->zipfExatos = 0;
+    carga->zipfSomaExata = 0;
+    carga->zipfZeta2 = 1.0 + pow(0.5, ZIPF_TETA);
+    carga->zipfAlfa = 1.0 / (1.0 - ZIPF_TETA);
+    return carga;
+}
+
+void destruirCarga(Carga_t *carga) {
+    free(carga);
+}
+
+registro_t *gerarRegistro(Carga_t *carga) {
+    if ((unsigned long long)carga->numRegistros >= LIMITE_INDICES) {
+        fprintf(stderr, "Erro: limite de registros da carga atingido.\n");
+        exit(EXIT_FAILURE);
+    }
+    unsigned long long chave = chaveDoIndice(carga, carga->numRegistros++);
+    const char *modelo = modelos[aleatorioAte(&carga->gerador, sizeof(modelos) / sizeof(modelos[0]))];
+    const char *cor = cores[aleatorioAte(&carga->gerador, sizeof(cores) / sizeof(cores[0]))];
+    int ano = ANO_INICIAL + (int)aleatorioAte(&carga->gerador, NUM_ANOS);
+    return criarRegistro(chave, modelo, ano, cor);
+}
+
+long carregarCarga(Carga_t *carga, BPlusTree_t *arvore, long numRegistros) {
+    registro_t **lote = (registro_t **)malloc(TAM_LOTE_CARGA * sizeof(registro_t *));
+    if (lote == NULL) {
+        perror("Erro ao alocar lote da carga");
+        exit(EXIT_FAILURE);
+    }
+    long gerados = 0;
+    while (gerados < numRegistros) {
+        int tamanho = numRegistros - gerados < TAM_LOTE_CARGA ? (int)(numRegistros - gerados) : TAM_LOTE_CARGA;
+        for (int i = 0; i < tamanho; i++) {
+            lote[i] = gerarRegistro(carga);
+        }
+        inserirLote(arvore, lote, tamanho);
+        gerados += tamanho;
+    }
+    free(lote);
+    return gerados;
+}
+
+unsigned long long escolherChave(Carga_t *carga, Distribuicao distribuicao) {
+    long n = carga->numRegistros;
+    if (n == 0) {
+        return chaveAusente(carga);
+    }
+    long indice;
+    switch (distribuicao) {
+        case DIST_SEQUENCIAL:
+            indice = carga->proximoSequencial++ % n;
+            break;
+        case DIST_ZIPF:
+            // Os itens populares ficam espalhados, e não concentrados nos primeiros índices
+            indice = (long)(_misturar((unsigned long long)_sortearZipf(carga, n)) % (unsigned long long)n);
+            break;
+        case DIST_RECENTES:
+            indice = n - 1 - _sortearZipf(carga, n);
+            break;
+        default:
+            indice = (long)aleatorioAte(&carga->gerador, (unsigned long long)n);
+            break;
+    }
+    return chaveDoIndice(carga, indice);
+}
+
+unsigned long long chaveAusente(Carga_t *carga) {
+    long indice = (long)(LIMITE_INDICES + aleatorioAte(&carga->gerador, AMPLITUDE_RENAVAM - LIMITE_INDICES));
+    return chaveDoIndice(carga, indice);
+}
+
+const MisturaOperacoes_t *misturaYCSB(char letra) {
+    int indice = letra - 'A';
+    if (indice < 0 || indice >= (int)(sizeof(misturas) / sizeof(misturas[0]))) {
+        return NULL;
+    }
+    return &misturas[indice];
+}
+
+TipoOperacaoCarga sortearOperacao(Carga_t *carga, const MisturaOperacoes_t *mistura) {
+    int sorteio = (int)aleatorioAte(&carga->gerador, 100);
+    int tipo = 0;
+    while (tipo < NUM_TIPOS_CARGA - 1 && sorteio >= mistura->percentuais[tipo]) {
+        sorteio -= mistura->percentuais[tipo];
+        tipo++;
+    }
+    return (TipoOperacaoCarga)tipo;
+}
+
+typedef struct {
+    long restantes;
+    long visitados;
+} Varredura;
+
+static int _visitarVarredura(registro_t *registro, void *contexto) {
+    (void)registro;
+    Varredura *varredura = (Varredura *)contexto;
+    varredura->visitados++;
+    return --varredura->restantes > 0;
+}
+
+void executarCarga(Carga_t *carga, BPlusTree_t *arvore, const MisturaOperacoes_t *mistura, long numOperacoes, ResultadoCarga_t *resultado) {
+    for (int t = 0; t < NUM_TIPOS_CARGA; t++) {
+        resultado->operacoes[t] = 0;
+    }
+    resultado->encontrados = 0;
+    resultado->ausentesEncontrados = 0;
+    resultado->registrosVarridos = 0;
+
+    for (long op = 0; op < numOperacoes; op++) {
+        TipoOperacaoCarga tipo = sortearOperacao(carga, mistura);
+        resultado->operacoes[tipo]++;
+
+        switch (tipo) {
+            case CARGA_BUSCA:
+                resultado->encontrados += buscar(arvore, escolherChave(carga, mistura->distribuicao)) != NULL;
+                break;
+            case CARGA_ATUALIZACAO: {
+                registro_t *registro = buscar(arvore, escolherChave(carga, mistura->distribuicao));
+                if (registro != NULL) {
+                    int ano = ANO_INICIAL + (int)aleatorioAte(&carga->gerador, NUM_ANOS);
+                    definirRegistroAno(registro, ano);
+                    resultado->encontrados++;
+                }
+                break;
+            }
+            case CARGA_INSERCAO:
+                inserir(arvore, gerarRegistro(carga));
+                break;
+            case CARGA_VARREDURA: {
+                Varredura varredura = {1 + (long)aleatorioAte(&carga->gerador, mistura->maxVarredura > 0 ? mistura->maxVarredura : 1), 0};
+                percorrerIntervalo(arvore, escolherChave(carga, mistura->distribuicao), RENAVAM_MAX, _visitarVarredura, &varredura);
+                resultado->registrosVarridos += varredura.visitados;
+                break;
+            }
+            case CARGA_AUSENTE:
+                resultado->ausentesEncontrados += buscar(arvore, chaveAusente(carga)) != NULL;
+                break;
+            default:
+                break;
+        }
+    }
+}
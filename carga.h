@@ -0,0 +1,77 @@
+#ifndef CARGA_H
+#define CARGA_H
+
+#include "BPlusTree.h"
+
+#define RENAVAM_MIN 10000000000ULL
+#define RENAVAM_MAX 99999999999ULL
+#define ZIPF_TETA 0.99 //assimetria padrão do YCSB
+
+// Gerador pseudoaleatório com estado explícito (xorshift64*): mesma semente, mesma carga
+typedef struct {
+    unsigned long long estado;
+} GeradorAleatorio_t;
+
+// Como as chaves são dispostas no intervalo do renavam ou escolhidas entre as existentes
+typedef enum {
+    DIST_UNIFORME, //espalhadas por todo o intervalo / qualquer registro com a mesma chance
+    DIST_SEQUENCIAL, //renavams consecutivos / registros percorridos em ordem de criação
+    DIST_ZIPF, //poucos registros concentram a maioria dos acessos (espalhados pelo intervalo)
+    DIST_RECENTES //Zipf sobre a ordem de criação: os mais novos são os mais acessados
+} Distribuicao;
+
+typedef enum {
+    CARGA_BUSCA,
+    CARGA_ATUALIZACAO, //busca e altera o registro encontrado
+    CARGA_INSERCAO,
+    CARGA_VARREDURA, //percorre até 'maxVarredura' registros a partir de uma chave existente
+    CARGA_AUSENTE, //busca de uma chave que não existe
+    NUM_TIPOS_CARGA
+} TipoOperacaoCarga;
+
+// Proporção de cada operação (percentuais que somam 100), no estilo das cargas A-F do YCSB
+typedef struct {
+    const char *nome;
+    int percentuais[NUM_TIPOS_CARGA]; //na ordem de TipoOperacaoCarga
+    Distribuicao distribuicao; //como as chaves existentes são escolhidas
+    int maxVarredura; //tamanho máximo de uma varredura
+} MisturaOperacoes_t;
+
+// Gerador de registros e operações
+typedef struct {
+    GeradorAleatorio_t gerador;
+    Distribuicao disposicao; //DIST_SEQUENCIAL ou espalhada (qualquer outra)
+    unsigned long long chavesFeistel[4]; //chaves das rodadas da permutação
+    long numRegistros; //registros gerados até agora (índices 0..numRegistros-1)
+    long proximoSequencial; //cursor da escolha sequencial
+    long zipfN; //número de itens para o qual os parâmetros de Zipf foram calculados
+    double zipfZetaN, zipfEta, zipfAlfa, zipfZeta2;
+    long zipfExatos; //termos já somados em zipfSomaExata (até ZIPF_TERMOS_EXATOS)
+    double zipfSomaExata; //parte exata de zeta, estendida quando n cresce
+} Carga_t;
+
+// Contadores de uma execução
+typedef struct {
+    long operacoes[NUM_TIPOS_CARGA]; //operações executadas de cada tipo
+    long encontrados; //buscas e atualizações que acharam o registro
+    long ausentesEncontrados; //buscas de chaves ausentes que acharam algo (deve ser 0)
+    long registrosVarridos; //registros visitados pelas varreduras
+} ResultadoCarga_t;
+
+void semearGerador(GeradorAleatorio_t *gerador, unsigned long long semente);
+unsigned long long proximoAleatorio(GeradorAleatorio_t *gerador);
+unsigned long long aleatorioAte(GeradorAleatorio_t *gerador, unsigned long long limite); //valor em [0, limite)
+double aleatorioReal(GeradorAleatorio_t *gerador); //valor em [0, 1)
+
+Carga_t *criarCarga(unsigned long long semente, Distribuicao disposicao); //disposição das chaves dos registros gerados
+void destruirCarga(Carga_t *carga);
+unsigned long long chaveDoIndice(const Carga_t *carga, long indice); //renavam do registro de número 'indice' (único)
+registro_t *gerarRegistro(Carga_t *carga); //próximo registro novo, com modelo, cor e ano como em gerar_dados.py
+long carregarCarga(Carga_t *carga, BPlusTree_t *arvore, long numRegistros); //gera e insere os registros em lotes
+unsigned long long escolherChave(Carga_t *carga, Distribuicao distribuicao); //chave de um registro já gerado
+unsigned long long chaveAusente(Carga_t *carga); //chave que nunca será gerada
+const MisturaOperacoes_t *misturaYCSB(char letra); //misturas 'A' a 'F' (NULL se não existir)
+TipoOperacaoCarga sortearOperacao(Carga_t *carga, const MisturaOperacoes_t *mistura); //tipo da próxima operação segundo os percentuais
+void executarCarga(Carga_t *carga, BPlusTree_t *arvore, const MisturaOperacoes_t *mistura, long numOperacoes, ResultadoCarga_t *resultado);
+
+#endif // CARGA_H
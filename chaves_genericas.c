@@ -0,0 +1,2 @@
+#define AG_IMPLEMENTACAO
+#include "chaves_genericas.h"
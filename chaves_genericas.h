@@ -0,0 +1,66 @@
+// Especializações da árvore B+ genérica (arvore_generica.h) por tipo de chave.
+// chaves_genericas.c inclui este arquivo com AG_IMPLEMENTACAO definido para gerar
+// as funções; nos demais arquivos só as declarações são geradas.
+#ifndef CHAVES_GENERICAS_TIPOS
+#define CHAVES_GENERICAS_TIPOS
+
+#include <stdint.h>
+#include <string.h>
+#include "BPlusTree.h"
+
+// Tamanho de nó usado para calcular a ordem de cada especialização: chaves
+// menores cabem em maior número no mesmo espaço, aumentando o fanout.
+#define TAM_NODO_GENERICO 512
+#define ORDEM_POR_TAMANHO(TipoChave) ((int)(TAM_NODO_GENERICO / (sizeof(TipoChave) + sizeof(void *))))
+
+//chave composta (modelo, ano); o renavam desempata veículos iguais
+typedef struct {
+    char modelo[TAM_MODELO];
+    int ano;
+    unsigned long long renavam;
+} chave_modelo_ano_t;
+
+static inline int menorModeloAno(const chave_modelo_ano_t *a, const chave_modelo_ano_t *b) {
+    int comparacao = strcmp(a->modelo, b->modelo);
+    if (comparacao != 0) {
+        return comparacao < 0;
+    }
+    if (a->ano != b->ano) {
+        return a->ano < b->ano;
+    }
+    return a->renavam < b->renavam;
+}
+
+#define MENOR_NUMERICO(a, b) ((a) < (b))
+#define MENOR_MODELO_ANO(a, b) menorModeloAno(&(a), &(b))
+
+#endif // CHAVES_GENERICAS_TIPOS
+
+#if !defined(CHAVES_GENERICAS_H) || defined(AG_IMPLEMENTACAO)
+#define CHAVES_GENERICAS_H
+
+//chaves de 32 bits (maior fanout)
+#define AG_NOME ArvoreU32
+#define AG_CHAVE uint32_t
+#define AG_VALOR registro_t *
+#define AG_ORDEM ORDEM_POR_TAMANHO(uint32_t)
+#define AG_MENOR MENOR_NUMERICO
+#include "arvore_generica.h"
+
+//chaves de 64 bits (renavam)
+#define AG_NOME ArvoreU64
+#define AG_CHAVE unsigned long long
+#define AG_VALOR registro_t *
+#define AG_ORDEM ORDEM_POR_TAMANHO(unsigned long long)
+#define AG_MENOR MENOR_NUMERICO
+#include "arvore_generica.h"
+
+//chave composta (modelo, ano, renavam)
+#define AG_NOME ArvoreModeloAno
+#define AG_CHAVE chave_modelo_ano_t
+#define AG_VALOR registro_t *
+#define AG_ORDEM ORDEM_POR_TAMANHO(chave_modelo_ano_t)
+#define AG_MENOR MENOR_MODELO_ANO
+#include "arvore_generica.h"
+
+#endif // CHAVES_GENERICAS_H
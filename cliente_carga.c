@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "carga.h"
+#include "protocolo.h"
+
+#define SEMENTE_PADRAO 42
+#define TAM_VARREDURA_PADRAO 100
+
+// Parâmetros comuns a todas as conexões
+typedef struct {
+    const char *caminho;
+    long registrosServidor; //registros carregados pelo servidor com a mesma semente
+    unsigned long long semente;
+    const MisturaOperacoes_t *mistura;
+    int profundidade; //requisições em voo por conexão (pipelining)
+    long operacoes; //operações por conexão
+} Configuracao_t;
+
+// Uma conexão, atendida por uma thread
+typedef struct {
+    const Configuracao_t *configuracao;
+    int indice;
+    double *latencias; //segundos, uma por operação
+    long naoEncontrados;
+    long invalidas;
+} Cliente_t;
+
+static double _agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int _conectar(const char *caminho) {
+    struct sockaddr_un endereco;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("Erro ao criar socket");
+        exit(EXIT_FAILURE);
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminho, sizeof(endereco.sun_path) - 1);
+    if (connect(fd, (struct sockaddr *)&endereco, sizeof(endereco)) < 0) {
+        perror("Erro ao conectar ao servidor");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+// Acrescenta em 'buffer' uma requisição sorteada segundo a mistura
+static size_t _montarRequisicao(Carga_t *carga, const MisturaOperacoes_t *mistura, uint32_t id, char *buffer) {
+    CabecalhoRequisicao_t cabecalho = {0, id, 0, {0}};
+    char *corpo = buffer + sizeof(cabecalho);
+    TipoOperacaoCarga tipo = sortearOperacao(carga, mistura);
+    switch (tipo) {
+        case CARGA_ATUALIZACAO:
+        case CARGA_INSERCAO: {
+            // Inserções usam chaves da faixa reservada às ausentes, que nenhum registro inicial usa
+            RegistroProtocolo_t registro;
+            memset(&registro, 0, sizeof(registro));
+            registro.chave = tipo == CARGA_INSERCAO ? chaveAusente(carga) : escolherChave(carga, mistura->distribuicao);
+            registro.ano = 1995 + (int)aleatorioAte(&carga->gerador, 30);
+            strcpy(registro.modelo, "Gol");
+            strcpy(registro.cor, "Preto");
+            cabecalho.operacao = OP_PUT;
+            cabecalho.tamanho = sizeof(registro);
+            memcpy(corpo, &registro, sizeof(registro));
+            break;
+        }
+        case CARGA_VARREDURA: {
+            IntervaloProtocolo_t intervalo = {escolherChave(carga, mistura->distribuicao), RENAVAM_MAX,
+                                              1 + (uint32_t)aleatorioAte(&carga->gerador, mistura->maxVarredura > 0 ? mistura->maxVarredura : TAM_VARREDURA_PADRAO), 0};
+            cabecalho.operacao = OP_RANGE;
+            cabecalho.tamanho = sizeof(intervalo);
+            memcpy(corpo, &intervalo, sizeof(intervalo));
+            break;
+        }
+        default: {
+            uint64_t chave = escolherChave(carga, mistura->distribuicao);
+            cabecalho.operacao = OP_GET;
+            cabecalho.tamanho = sizeof(chave);
+            memcpy(corpo, &chave, sizeof(chave));
+            break;
+        }
+    }
+    memcpy(buffer, &cabecalho, sizeof(cabecalho));
+    return sizeof(cabecalho) + cabecalho.tamanho;
+}
+
+// Mantém 'profundidade' requisições em voo: a cada lote de respostas recebido, envia
+// o mesmo número de requisições novas em uma única escrita. Enviar e receber são
+// intercalados pelo poll, para que um lote grande não trave com o servidor esperando
+// o cliente ler as respostas.
+static void *_executarCliente(void *argumento) {
+    Cliente_t *cliente = (Cliente_t *)argumento;
+    const Configuracao_t *configuracao = cliente->configuracao;
+    int fd = _conectar(configuracao->caminho);
+
+    // Mesma semente do servidor (mesmas chaves); o sorteio de cada conexão é independente
+    Carga_t *carga = criarCarga(configuracao->semente, DIST_UNIFORME);
+    carga->numRegistros = configuracao->registrosServidor;
+    semearGerador(&carga->gerador, configuracao->semente + 1 + cliente->indice);
+
+    size_t tamRequisicao = sizeof(CabecalhoRequisicao_t) + sizeof(RegistroProtocolo_t);
+    char *saida = (char *)malloc(configuracao->profundidade * tamRequisicao);
+    double *envios = (double *)malloc(configuracao->profundidade * sizeof(double));
+    size_t capEntrada = 1 << 16, tamEntrada = 0;
+    char *entrada = (char *)malloc(capEntrada);
+    if (saida == NULL || envios == NULL || entrada == NULL) {
+        perror("Erro ao alocar buffers do cliente");
+        exit(EXIT_FAILURE);
+    }
+
+    long enviadas = 0, recebidas = 0;
+    size_t tamSaida = 0, bytesEnviados = 0;
+    while (recebidas < configuracao->operacoes) {
+        if (bytesEnviados == tamSaida) {
+            tamSaida = bytesEnviados = 0;
+            double instante = _agora();
+            while (enviadas < configuracao->operacoes && enviadas - recebidas < configuracao->profundidade) {
+                envios[enviadas % configuracao->profundidade] = instante;
+                tamSaida += _montarRequisicao(carga, configuracao->mistura, (uint32_t)enviadas, saida + tamSaida);
+                enviadas++;
+            }
+        }
+        struct pollfd espera = {fd, POLLIN | (bytesEnviados < tamSaida ? POLLOUT : 0), 0};
+        if (poll(&espera, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Erro no poll");
+            exit(EXIT_FAILURE);
+        }
+        if (espera.revents & POLLOUT) {
+            ssize_t n = send(fd, saida + bytesEnviados, tamSaida - bytesEnviados, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("Erro ao enviar requisições");
+                exit(EXIT_FAILURE);
+            }
+            bytesEnviados += n > 0 ? (size_t)n : 0;
+        }
+        if (!(espera.revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+
+        if (capEntrada - tamEntrada < 1 << 15) {
+            capEntrada *= 2;
+            entrada = (char *)realloc(entrada, capEntrada);
+            if (entrada == NULL) {
+                perror("Erro ao alocar buffer de respostas");
+                exit(EXIT_FAILURE);
+            }
+        }
+        ssize_t n = read(fd, entrada + tamEntrada, capEntrada - tamEntrada);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Erro: conexão encerrada pelo servidor.\n");
+            exit(EXIT_FAILURE);
+        }
+        tamEntrada += (size_t)n;
+        double instante = _agora();
+
+        size_t posicao = 0;
+        CabecalhoResposta_t cabecalho;
+        while (tamEntrada - posicao >= sizeof(cabecalho)) {
+            memcpy(&cabecalho, entrada + posicao, sizeof(cabecalho));
+            if (tamEntrada - posicao < sizeof(cabecalho) + cabecalho.tamanho) {
+                break;
+            }
+            cliente->latencias[recebidas++] = instante - envios[cabecalho.id % configuracao->profundidade];
+            cliente->naoEncontrados += cabecalho.status == STATUS_NAO_ENCONTRADO;
+            cliente->invalidas += cabecalho.status == STATUS_INVALIDA;
+            posicao += sizeof(cabecalho) + cabecalho.tamanho;
+        }
+        memmove(entrada, entrada + posicao, tamEntrada - posicao);
+        tamEntrada -= posicao;
+    }
+
+    close(fd);
+    free(saida);
+    free(envios);
+    free(entrada);
+    destruirCarga(carga);
+    return NULL;
+}
+
+static int _compararLatencias(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double _percentil(const double *ordenadas, long n, double p) {
+    long indice = (long)(p * (n - 1));
+    return ordenadas[indice];
+}
+
+static void _uso(const char *programa) {
+    fprintf(stderr, "Uso: %s [-s caminho do socket] [-n registros do servidor] [-r semente] [-m mistura A-F]"
+                    " [-c conexões] [-p requisições em voo por conexão] [-o operações por conexão]\n", programa);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    Configuracao_t configuracao = {CAMINHO_SOCKET_PADRAO, 0, SEMENTE_PADRAO, misturaYCSB('C'), 16, 100000};
+    int numConexoes = 4;
+    int opcao;
+    while ((opcao = getopt(argc, argv, "s:n:r:m:c:p:o:")) != -1) {
+        switch (opcao) {
+            case 's': configuracao.caminho = optarg; break;
+            case 'n': configuracao.registrosServidor = atol(optarg); break;
+            case 'r': configuracao.semente = strtoull(optarg, NULL, 10); break;
+            case 'm': configuracao.mistura = misturaYCSB(optarg[0]); break;
+            case 'c': numConexoes = atoi(optarg); break;
+            case 'p': configuracao.profundidade = atoi(optarg); break;
+            case 'o': configuracao.operacoes = atol(optarg); break;
+            default: _uso(argv[0]);
+        }
+    }
+    if (configuracao.mistura == NULL || numConexoes < 1 || configuracao.profundidade < 1 || configuracao.operacoes < 1) {
+        _uso(argv[0]);
+    }
+
+    Cliente_t *clientes = (Cliente_t *)calloc(numConexoes, sizeof(Cliente_t));
+    pthread_t *threads = (pthread_t *)malloc(numConexoes * sizeof(pthread_t));
+    if (clientes == NULL || threads == NULL) {
+        perror("Erro ao alocar clientes");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < numConexoes; i++) {
+        clientes[i].configuracao = &configuracao;
+        clientes[i].indice = i;
+        clientes[i].latencias = (double *)malloc(configuracao.operacoes * sizeof(double));
+        if (clientes[i].latencias == NULL) {
+            perror("Erro ao alocar latências");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    double inicio = _agora();
+    for (int i = 0; i < numConexoes; i++) {
+        pthread_create(&threads[i], NULL, _executarCliente, &clientes[i]);
+    }
+    for (int i = 0; i < numConexoes; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double tempo = _agora() - inicio;
+
+    long total = numConexoes * configuracao.operacoes, naoEncontrados = 0, invalidas = 0;
+    double *todas = (double *)malloc(total * sizeof(double));
+    if (todas == NULL) {
+        perror("Erro ao alocar latências");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < numConexoes; i++) {
+        memcpy(todas + i * configuracao.operacoes, clientes[i].latencias, configuracao.operacoes * sizeof(double));
+        naoEncontrados += clientes[i].naoEncontrados;
+        invalidas += clientes[i].invalidas;
+        free(clientes[i].latencias);
+    }
+    qsort(todas, total, sizeof(double), _compararLatencias);
+
+    printf("Mistura %s | %d conexões x %d em voo | %ld operações em %.6f s (%.0f op/s)\n",
+           configuracao.mistura->nome, numConexoes, configuracao.profundidade, total, tempo, total / tempo);
+    printf("Latência (us): p50 %.1f | p99 %.1f | p99.9 %.1f | máx %.1f | Não encontrados: %ld | Inválidas: %ld\n",
+           _percentil(todas, total, 0.50) * 1e6, _percentil(todas, total, 0.99) * 1e6,
+           _percentil(todas, total, 0.999) * 1e6, todas[total - 1] * 1e6, naoEncontrados, invalidas);
+
+    free(todas);
+    free(clientes);
+    free(threads);
+    return 0;
+}
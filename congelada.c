@@ -0,0 +1,182 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "congelada.h"
+#include "fila.h"
+
+#define CHAVE_MAXIMA 0xFFFFFFFFFFFFFFFFULL //usada para preencher posições vazias
+#define TAM_LINHA_CACHE 64
+
+// Aloca memória alinhada à linha de cache (tamanho arredondado para múltiplo do alinhamento)
+static void *_alocarAlinhado(size_t bytes) {
+    size_t tamanho = (bytes + TAM_LINHA_CACHE - 1) / TAM_LINHA_CACHE * TAM_LINHA_CACHE;
+    if (tamanho == 0) {
+        tamanho = TAM_LINHA_CACHE;
+    }
+    void *ptr = aligned_alloc(TAM_LINHA_CACHE, tamanho);
+    if (ptr == NULL) {
+        perror("Erro ao alocar árvore congelada");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+// Percorre a árvore em profundidade e devolve as folhas da esquerda para a direita
+static nodo_t **_coletarFolhas(nodo_t *raiz, long *numFolhas, long *numRegistros) {
+    long capacidade = 64;
+    nodo_t **folhas = (nodo_t **)malloc(capacidade * sizeof(nodo_t *));
+    if (folhas == NULL) {
+        perror("Erro ao alocar vetor de folhas");
+        exit(EXIT_FAILURE);
+    }
+    *numFolhas = 0;
+    *numRegistros = 0;
+
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, raiz, PERCURSO_PROFUNDIDADE);
+    nodo_t *atual;
+    while ((atual = proximoNodo(&percurso, NULL)) != NULL) {
+        if (atual->folha) {
+            if (*numFolhas == capacidade) {
+                capacidade *= 2;
+                folhas = (nodo_t **)realloc(folhas, capacidade * sizeof(nodo_t *));
+                if (folhas == NULL) {
+                    perror("Erro ao realocar vetor de folhas");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            folhas[(*numFolhas)++] = atual;
+            *numRegistros += atual->numChaves;
+        }
+    }
+    encerrarPercurso(&percurso);
+    return folhas;
+}
+
+ArvoreCongelada_t *congelarArvore(BPlusTree_t *arvore) {
+    if (arvore == NULL || arvore->raiz == NULL) {
+        return NULL;
+    }
+    ArvoreCongelada_t *congelada = (ArvoreCongelada_t *)malloc(sizeof(ArvoreCongelada_t));
+    if (congelada == NULL) {
+        perror("Erro ao alocar árvore congelada");
+        exit(EXIT_FAILURE);
+    }
+
+    // Etapa 1: compacta as folhas em vetores contíguos
+    long numFolhas, numRegistros;
+    nodo_t **folhas = _coletarFolhas(arvore->raiz, &numFolhas, &numRegistros);
+
+    long numBlocos = (numRegistros + CONGELADA_FOLHA - 1) / CONGELADA_FOLHA;
+    if (numBlocos == 0) {
+        numBlocos = 1;
+    }
+    congelada->numRegistros = numRegistros;
+    congelada->chavesFolhas = (unsigned long long *)_alocarAlinhado(numBlocos * CONGELADA_FOLHA * sizeof(unsigned long long));
+    congelada->registros = (registro_t **)_alocarAlinhado(numBlocos * CONGELADA_FOLHA * sizeof(registro_t *));
+
+    long pos = 0;
+    for (long f = 0; f < numFolhas; f++) {
+        for (int i = 0; i < folhas[f]->numChaves; i++) {
+            congelada->chavesFolhas[pos] = folhas[f]->chaves[i];
+            congelada->registros[pos] = folhas[f]->registros[i];
+            pos++;
+        }
+    }
+    for (; pos < numBlocos * CONGELADA_FOLHA; pos++) {
+        congelada->chavesFolhas[pos] = CHAVE_MAXIMA;
+        congelada->registros[pos] = NULL;
+    }
+    free(folhas);
+
+    // Etapa 2: calcula quantos nós cada nível interno terá (de baixo para cima)
+    long nosPorNivel[64];
+    int numNiveis = 0;
+    long nos = numBlocos;
+    while (nos > 1) {
+        nos = (nos + CONGELADA_FANOUT - 1) / CONGELADA_FANOUT;
+        nosPorNivel[numNiveis++] = nos;
+    }
+    congelada->numNiveis = numNiveis;
+    congelada->inicioNivel = (long *)malloc((numNiveis + 1) * sizeof(long));
+    if (congelada->inicioNivel == NULL) {
+        perror("Erro ao alocar níveis da árvore congelada");
+        exit(EXIT_FAILURE);
+    }
+
+    // O nível 0 é a raiz; os níveis ficam em sequência (ordem BFS)
+    long totalSeparadores = 0;
+    for (int l = 0; l < numNiveis; l++) {
+        congelada->inicioNivel[l] = totalSeparadores;
+        totalSeparadores += nosPorNivel[numNiveis - 1 - l] * (CONGELADA_FANOUT - 1);
+    }
+    congelada->inicioNivel[numNiveis] = totalSeparadores;
+    congelada->chavesInternas = (unsigned long long *)_alocarAlinhado(totalSeparadores * sizeof(unsigned long long));
+
+    // Etapa 3: preenche os separadores de baixo para cima. Cada separador é a
+    // menor chave do filho correspondente (filhos 1..FANOUT-1 de cada nó).
+    unsigned long long *minimos = (unsigned long long *)malloc(numBlocos * sizeof(unsigned long long));
+    if (minimos == NULL) {
+        perror("Erro ao alocar vetor auxiliar");
+        exit(EXIT_FAILURE);
+    }
+    for (long b = 0; b < numBlocos; b++) {
+        minimos[b] = congelada->chavesFolhas[b * CONGELADA_FOLHA];
+    }
+    long nosAbaixo = numBlocos;
+    for (int l = numNiveis - 1; l >= 0; l--) {
+        long nosNivel = nosPorNivel[numNiveis - 1 - l];
+        unsigned long long *separadores = congelada->chavesInternas + congelada->inicioNivel[l];
+        for (long j = 0; j < nosNivel; j++) {
+            for (int c = 1; c < CONGELADA_FANOUT; c++) {
+                long filho = j * CONGELADA_FANOUT + c;
+                separadores[j * (CONGELADA_FANOUT - 1) + c - 1] = (filho < nosAbaixo) ? minimos[filho] : CHAVE_MAXIMA;
+            }
+            minimos[j] = minimos[j * CONGELADA_FANOUT];
+        }
+        nosAbaixo = nosNivel;
+    }
+    free(minimos);
+
+    return congelada;
+}
+
+void destruirArvoreCongelada(ArvoreCongelada_t *congelada) {
+    if (congelada == NULL) {
+        return;
+    }
+    free(congelada->chavesInternas);
+    free(congelada->inicioNivel);
+    free(congelada->chavesFolhas);
+    free(congelada->registros);
+    free(congelada);
+}
+
+// Conta quantas das n chaves ordenadas são <= chave (busca binária sem desvios)
+static inline int _contarMenoresOuIguais(const unsigned long long *chaves, int n, unsigned long long chave) {
+    const unsigned long long *base = chaves;
+    while (n > 1) {
+        int metade = n / 2;
+        base = (base[metade - 1] <= chave) ? base + metade : base;
+        n -= metade;
+    }
+    return (int)(base - chaves) + (base[0] <= chave);
+}
+
+// Desce pelos níveis usando apenas aritmética de índices, sem seguir ponteiros
+registro_t *buscarCongelada(const ArvoreCongelada_t *congelada, unsigned long long chave) {
+    if (congelada == NULL || congelada->numRegistros == 0 ||
+        chave > congelada->chavesFolhas[congelada->numRegistros - 1]) {
+        return NULL;
+    }
+    long pos = 0;
+    for (int l = 0; l < congelada->numNiveis; l++) {
+        const unsigned long long *separadores = congelada->chavesInternas + congelada->inicioNivel[l] + pos * (CONGELADA_FANOUT - 1);
+        pos = pos * CONGELADA_FANOUT + _contarMenoresOuIguais(separadores, CONGELADA_FANOUT - 1, chave);
+    }
+    const unsigned long long *bloco = congelada->chavesFolhas + pos * CONGELADA_FOLHA;
+    int i = _contarMenoresOuIguais(bloco, CONGELADA_FOLHA, chave);
+    if (i > 0 && bloco[i - 1] == chave) {
+        return congelada->registros[pos * CONGELADA_FOLHA + i - 1];
+    }
+    return NULL;
+}
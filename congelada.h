@@ -0,0 +1,32 @@
+#ifndef CONGELADA_H
+#define CONGELADA_H
+
+#include "BPlusTree.h"
+
+// Número de filhos de cada nó interno congelado (FANOUT - 1 chaves = 1 linha de cache)
+#ifndef CONGELADA_FANOUT
+#define CONGELADA_FANOUT 9
+#endif
+
+// Número de chaves por bloco de folha congelada
+#ifndef CONGELADA_FOLHA
+#define CONGELADA_FOLHA 8
+#endif
+
+// Cópia somente leitura da árvore B+, sem ponteiros entre nós.
+// Os níveis internos ficam contíguos em ordem BFS: o nó j de um nível tem
+// como filhos os nós j * CONGELADA_FANOUT + c do nível seguinte.
+typedef struct {
+    unsigned long long *chavesInternas; //separadores de todos os níveis internos, em ordem BFS
+    long *inicioNivel; //deslocamento de cada nível interno em chavesInternas
+    int numNiveis; //quantidade de níveis internos
+    unsigned long long *chavesFolhas; //chaves das folhas compactadas em um único vetor
+    registro_t **registros; //registros na mesma ordem de chavesFolhas
+    long numRegistros; //total de registros congelados
+} ArvoreCongelada_t;
+
+ArvoreCongelada_t *congelarArvore(BPlusTree_t *arvore); //cria a versão congelada a partir da árvore atual
+void destruirArvoreCongelada(ArvoreCongelada_t *congelada); //libera a versão congelada (não libera os registros)
+registro_t *buscarCongelada(const ArvoreCongelada_t *congelada, unsigned long long chave); //busca sem seguir ponteiros acima das folhas
+
+#endif // CONGELADA_H
@@ -1,152 +1,317 @@
-#include <stdlib.h>
-#include <stdio.h>
-#include "fila.h" 
-
-// Nó da fila, armazena um ponteiro para um nó da árvore B+
-// Esta estrutura agora é "privada" para o módulo da fila.
-typedef struct FilaNodo {
-    nodo_t* nodo_arvore;
-    struct FilaNodo* proximo;
-} FilaNodo;
-
-// Estrutura da Fila, agora definida completamente aqui.
-struct Fila {
-    FilaNodo* frente;
-    FilaNodo* tras;
-};
-
-// Cria uma fila vazia
-Fila* criarFila() {
-    Fila* f = (Fila*)malloc(sizeof(Fila));
-    if (f) {
-        f->frente = f->tras = NULL;
-    }
-    return f;
-}
-
-// Enfileira um nó da árvore B+
-void enfileirar(Fila* f, nodo_t* nodo_arvore) {
-    if (!f) return;
-    FilaNodo* temp = (FilaNodo*)malloc(sizeof(FilaNodo));
-    if (!temp) return; // Falha na alocação
-
-    temp->nodo_arvore = nodo_arvore;
-    temp->proximo = NULL;
-
-    if (f->tras == NULL) {
-        f->frente = f->tras = temp;
-        return;
-    }
-    f->tras->proximo = temp;
-    f->tras = temp;
-}
-
-// Desenfileira um nó da árvore B+
-nodo_t* desenfileirar(Fila* f) {
-    if (!f || f->frente == NULL) return NULL;
-
-    FilaNodo* temp = f->frente;
-    nodo_t* nodo_retornado = temp->nodo_arvore;
-    f->frente = f->frente->proximo;
-
-    if (f->frente == NULL) {
-        f->tras = NULL;
-    }
-
-    free(temp);
-    return nodo_retornado;
-}
-
-// Verifica se a fila está vazia
-int filaVazia(Fila* f) {
-    return (f == NULL || f->frente == NULL);
-}
-
-// Libera a memória da fila
-void destruirFila(Fila* f) {
-    if (!f) return;
-    while (!filaVazia(f)) {
-        desenfileirar(f); // Apenas desenfileira para liberar os FilaNodos
-    }
-    free(f); // Libera a estrutura da fila em si
-}
-
-// Coloque esta função no lugar da sua 'imprimeArvore' antiga
-void imprimeArvorePorNiveis(nodo_t *raiz) {
-    if (raiz == NULL) {
-        printf("Árvore vazia.\n");
-        return;
-    }
-
-    printf("--- Impressão da Árvore B+ por Níveis ---\n\n");
-
-    Fila* fila = criarFila();
-    enfileirar(fila, raiz);
-    enfileirar(fila, NULL); // Marcador de fim de nível
-
-    int nivel = 0;
-    printf("Nível %d (Raiz): ", nivel);
-
-    while (!filaVazia(fila)) {
-        nodo_t *atual = desenfileirar(fila);
-
-        if (atual == NULL) { // Fim de um nível
-            printf("\n");
-            if (!filaVazia(fila)) {
-                enfileirar(fila, NULL); // Adiciona marcador para o próximo nível
-                nivel++;
-                printf("Nível %d:         ", nivel);
-            }
-        } else {
-            // Imprime o nó atual
-            if (atual->folha) {
-                printf("{Folha: ");
-            } else {
-                printf("[Interno: ");
-            }
-
-            for (int i = 0; i < atual->numChaves; i++) {
-                printf("%llu ", atual->chaves[i]);
-            }
-            printf("]  ");
-
-            // Enfileira os filhos se não for um nó folha
-            if (!atual->folha) {
-                for (int i = 0; i <= atual->numChaves; i++) {
-                    if (atual->filhos[i] != NULL) {
-                        enfileirar(fila, atual->filhos[i]);
-                    }
-                }
-            }
-        }
-    }
-    
-    printf("\n--- Sequência de Nós Folha (Encadeamento) ---\n\n");
-    // Encontra o primeiro nó folha
-    nodo_t *folha_atual = raiz;
-    while(folha_atual != NULL && !folha_atual->folha){
-        folha_atual = folha_atual->filhos[0];
-    }
-    
-    if(folha_atual == NULL) {
-        printf("Nenhum nó folha encontrado.\n");
-    }
-
-    // Percorre a lista encadeada de folhas
-    while(folha_atual != NULL){
-        printf("{");
-        for(int i = 0; i < folha_atual->numChaves; i++){
-            printf("%llu", folha_atual->registros[i]->chave);
-            if(i < folha_atual->numChaves - 1) printf(", ");
-        }
-        printf("}");
-        
-        if(folha_atual->proximo != NULL){
-            printf(" -> ");
-        }
-        folha_atual = folha_atual->proximo;
-    }
-    printf("\n\n--------------------------------------------\n");
-    
-    destruirFila(fila);
+#include <stdlib.h>
+#include <stdio.h>
+#include "fila.h" 
+
+#define CAPACIDADE_INICIAL_FILA 64 //potência de 2
+
+// Item da fila: o nó da árvore e o seu nível
+typedef struct {
+    nodo_t* nodo_arvore;
+    int nivel;
+} ItemFila;
+
+// Estrutura da Fila: buffer circular com capacidade potência de 2, que dobra quando
+// enche. Um único bloco serve todo o percurso, sem alocação por nó visitado.
+struct Fila {
+    ItemFila* itens;
+    size_t capacidade;
+    size_t inicio; //posição do primeiro item
+    size_t tamanho; //itens na fila
+};
+
+// Cria uma fila vazia
+Fila* criarFila() {
+    Fila* f = (Fila*)malloc(sizeof(Fila));
+    if (f == NULL) {
+        perror("Erro ao alocar fila");
+        exit(EXIT_FAILURE);
+    }
+    f->itens = (ItemFila*)malloc(CAPACIDADE_INICIAL_FILA * sizeof(ItemFila));
+    if (f->itens == NULL) {
+        perror("Erro ao alocar fila");
+        exit(EXIT_FAILURE);
+    }
+    f->capacidade = CAPACIDADE_INICIAL_FILA;
+    f->inicio = f->tamanho = 0;
+    return f;
+}
+
+// Dobra a capacidade, desenrolando o buffer circular no início do novo bloco
+static void _crescerFila(Fila* f) {
+    ItemFila* novos = (ItemFila*)malloc(2 * f->capacidade * sizeof(ItemFila));
+    if (novos == NULL) {
+        perror("Erro ao realocar fila");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < f->tamanho; i++) {
+        novos[i] = f->itens[(f->inicio + i) & (f->capacidade - 1)];
+    }
+    free(f->itens);
+    f->itens = novos;
+    f->capacidade *= 2;
+    f->inicio = 0;
+}
+
+static void _inserirFinal(Fila* f, nodo_t* nodo_arvore, int nivel) {
+    if (f->tamanho == f->capacidade) {
+        _crescerFila(f);
+    }
+    ItemFila* item = &f->itens[(f->inicio + f->tamanho) & (f->capacidade - 1)];
+    item->nodo_arvore = nodo_arvore;
+    item->nivel = nivel;
+    f->tamanho++;
+}
+
+// Enfileira um nó da árvore B+
+void enfileirar(Fila* f, nodo_t* nodo_arvore) {
+    if (!f) return;
+    _inserirFinal(f, nodo_arvore, 0);
+}
+
+static ItemFila _retirarInicio(Fila* f) {
+    ItemFila item = f->itens[f->inicio];
+    f->inicio = (f->inicio + 1) & (f->capacidade - 1);
+    f->tamanho--;
+    return item;
+}
+
+static ItemFila _retirarFinal(Fila* f) {
+    f->tamanho--;
+    return f->itens[(f->inicio + f->tamanho) & (f->capacidade - 1)];
+}
+
+// Desenfileira um nó da árvore B+
+nodo_t* desenfileirar(Fila* f) {
+    if (filaVazia(f)) return NULL;
+    return _retirarInicio(f).nodo_arvore;
+}
+
+// Retira o último nó enfileirado (uso como pilha)
+nodo_t* desempilhar(Fila* f) {
+    if (filaVazia(f)) return NULL;
+    return _retirarFinal(f).nodo_arvore;
+}
+
+// Verifica se a fila está vazia
+int filaVazia(Fila* f) {
+    return (f == NULL || f->tamanho == 0);
+}
+
+// Libera a memória da fila
+void destruirFila(Fila* f) {
+    if (!f) return;
+    free(f->itens);
+    free(f);
+}
+
+// ====================================================================================
+// Percurso Iterativo
+// ====================================================================================
+
+void iniciarPercurso(Percurso_t *percurso, nodo_t *raiz, ModoPercurso modo) {
+    percurso->modo = modo;
+    percurso->raiz = raiz;
+    percurso->profundidade = -1;
+    percurso->ultimoNoCaminho = 0;
+    percurso->pendentes = NULL;
+    if (modo == PERCURSO_LARGURA) {
+        percurso->pendentes = criarFila();
+        if (raiz != NULL) {
+            _inserirFinal(percurso->pendentes, raiz, 0);
+        }
+        percurso->raiz = NULL;
+    }
+}
+
+static nodo_t *_proximoLargura(Percurso_t *percurso, int *nivel) {
+    Fila* f = percurso->pendentes;
+    if (filaVazia(f)) {
+        return NULL;
+    }
+    ItemFila item = _retirarInicio(f);
+    // O nó que sai daqui a DISTANCIA_PREFETCH chamadas já começa a ser lido
+    if (f->tamanho > DISTANCIA_PREFETCH) {
+        _prefetchNodo(f->itens[(f->inicio + DISTANCIA_PREFETCH) & (f->capacidade - 1)].nodo_arvore);
+    }
+
+    nodo_t *nodo = item.nodo_arvore;
+    if (!nodo->folha) {
+        // Reserva espaço para todos os filhos de uma vez e os copia sem testar a capacidade
+        int numFilhos = nodo->numChaves + 1;
+        while (f->capacidade - f->tamanho < (size_t)numFilhos) {
+            _crescerFila(f);
+        }
+        size_t mascara = f->capacidade - 1, fim = f->inicio + f->tamanho;
+        for (int i = 0; i < numFilhos; i++) {
+            ItemFila* destino = &f->itens[(fim + i) & mascara];
+            destino->nodo_arvore = nodo->filhos[i];
+            destino->nivel = item.nivel + 1;
+        }
+        f->tamanho += numFilhos;
+    }
+    if (nivel != NULL) {
+        *nivel = item.nivel;
+    }
+    return nodo;
+}
+
+// Coloca um nó interno no topo do caminho. Todos os filhos de um nó estão no mesmo
+// nível, então basta olhar o primeiro para saber se são folhas.
+static void _empilharCaminho(Percurso_t *percurso, int d, nodo_t *nodo) {
+    percurso->caminho[d] = nodo;
+    percurso->proximoFilho[d] = 0;
+    percurso->filhosFolhas[d] = nodo->filhos[0]->folha;
+}
+
+nodo_t *proximoNodoPendente(Percurso_t *percurso, int *nivel) {
+    if (percurso->modo == PERCURSO_LARGURA) {
+        return _proximoLargura(percurso, nivel);
+    }
+    int preOrdem = percurso->modo == PERCURSO_PROFUNDIDADE;
+    int d = percurso->profundidade;
+    nodo_t *nodo = percurso->raiz;
+    if (nodo != NULL) {
+        // Primeira chamada: uma raiz folha é o único nó; a interna abre o caminho
+        percurso->raiz = NULL;
+        if (nodo->folha) {
+            percurso->ultimoNoCaminho = 0;
+            if (nivel != NULL) {
+                *nivel = 0;
+            }
+            return nodo;
+        }
+        _empilharCaminho(percurso, d = 0, nodo);
+        if (preOrdem) {
+            percurso->profundidade = 0;
+            percurso->ultimoNoCaminho = 1;
+            if (nivel != NULL) {
+                *nivel = 0;
+            }
+            return nodo;
+        }
+    }
+
+    while (d >= 0) {
+        nodo_t *topo = percurso->caminho[d];
+        int i = percurso->proximoFilho[d];
+        if (i <= topo->numChaves) {
+            nodo_t *filho = topo->filhos[i];
+            percurso->proximoFilho[d] = i + 1;
+            if (i + DISTANCIA_PREFETCH <= topo->numChaves) {
+                _prefetchNodo(topo->filhos[i + DISTANCIA_PREFETCH]);
+            }
+            if (percurso->filhosFolhas[d]) {
+                percurso->profundidade = d;
+                percurso->ultimoNoCaminho = 0;
+                if (nivel != NULL) {
+                    *nivel = d + 1;
+                }
+                return filho;
+            }
+            _empilharCaminho(percurso, ++d, filho);
+            if (preOrdem) {
+                percurso->profundidade = d;
+                percurso->ultimoNoCaminho = 1;
+                if (nivel != NULL) {
+                    *nivel = d;
+                }
+                return filho;
+            }
+            continue;
+        }
+        // Filhos esgotados: sai do caminho (em pós-ordem é a vez dele)
+        d--;
+        if (!preOrdem) {
+            percurso->profundidade = d;
+            percurso->ultimoNoCaminho = 0;
+            if (nivel != NULL) {
+                *nivel = d + 1;
+            }
+            return topo;
+        }
+    }
+    percurso->profundidade = -1;
+    return NULL;
+}
+
+nodo_t *paiUltimoNodo(const Percurso_t *percurso, int *indice) {
+    int d = percurso->profundidade - percurso->ultimoNoCaminho;
+    if (percurso->modo == PERCURSO_LARGURA || d < 0) {
+        return NULL;
+    }
+    if (indice != NULL) {
+        *indice = percurso->proximoFilho[d] - 1;
+    }
+    return percurso->caminho[d];
+}
+
+void encerrarPercurso(Percurso_t *percurso) {
+    destruirFila(percurso->pendentes); //NULL em profundidade
+    percurso->pendentes = NULL;
+}
+
+// Coloque esta função no lugar da sua 'imprimeArvore' antiga
+void imprimeArvorePorNiveis(nodo_t *raiz) {
+    if (raiz == NULL) {
+        printf("Árvore vazia.\n");
+        return;
+    }
+
+    printf("--- Impressão da Árvore B+ por Níveis ---\n\n");
+
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, raiz, PERCURSO_LARGURA);
+
+    int nivelAtual = 0, nivel;
+    nodo_t *atual;
+    printf("Nível %d (Raiz): ", nivelAtual);
+
+    while ((atual = proximoNodo(&percurso, &nivel)) != NULL) {
+        if (nivel != nivelAtual) { // Início de um novo nível
+            nivelAtual = nivel;
+            printf("\nNível %d:         ", nivelAtual);
+        }
+
+        // Imprime o nó atual
+        if (atual->folha) {
+            printf("{Folha: ");
+        } else {
+            printf("[Interno: ");
+        }
+
+        for (int i = 0; i < atual->numChaves; i++) {
+            printf("%llu ", atual->chaves[i]);
+        }
+        printf("]  ");
+    }
+    printf("\n");
+    
+    printf("\n--- Sequência de Nós Folha (Encadeamento) ---\n\n");
+    // Encontra o primeiro nó folha
+    nodo_t *folha_atual = raiz;
+    while(folha_atual != NULL && !folha_atual->folha){
+        folha_atual = folha_atual->filhos[0];
+    }
+    
+    if(folha_atual == NULL) {
+        printf("Nenhum nó folha encontrado.\n");
+    }
+
+    // Percorre a lista encadeada de folhas
+    while(folha_atual != NULL){
+        printf("{");
+        for(int i = 0; i < folha_atual->numChaves; i++){
+            printf("%llu", folha_atual->registros[i]->chave);
+            if(i < folha_atual->numChaves - 1) printf(", ");
+        }
+        printf("}");
+        
+        if(folha_atual->proximo != NULL){
+            printf(" -> ");
+        }
+        folha_atual = folha_atual->proximo;
+    }
+    printf("\n\n--------------------------------------------\n");
+    
+    encerrarPercurso(&percurso);
 }
\ No newline at end of file
@@ -1,18 +1,79 @@
-#ifndef FILA_H
-#define FILA_H
-
-#include "BPlusTree.h" //
-
-// Estrutura da Fila
-typedef struct Fila Fila;
-
-// Funções Públicas (API da Fila)
-Fila* criarFila();
-void enfileirar(Fila* f, nodo_t* nodo_arvore);
-nodo_t* desenfileirar(Fila* f);
-int filaVazia(Fila* f);
-void destruirFila(Fila* f);
-
-void imprimeArvorePorNiveis(nodo_t *raiz);
-
-#endif // FILA_H
\ No newline at end of file
+#ifndef FILA_H
+#define FILA_H
+
+#include "BPlusTree.h" //
+
+#define DISTANCIA_PREFETCH 4 //nós à frente do próximo a ser entregue que são trazidos para o cache
+
+// Estrutura da Fila (deque em buffer circular; serve como fila e como pilha)
+typedef struct Fila Fila;
+
+// Ordem em que o percurso entrega os nós
+typedef enum {
+    PERCURSO_LARGURA, //nível a nível, da esquerda para a direita (BFS)
+    PERCURSO_PROFUNDIDADE, //pré-ordem, filhos da esquerda para a direita (DFS)
+    PERCURSO_POS_ORDEM //filhos antes do pai: o nó devolvido pode ser liberado em seguida
+} ModoPercurso;
+
+// Percurso iterativo da árvore (iniciar com iniciarPercurso). Em profundidade ele guarda
+// só o caminho até o nó atual, como a pilha de chamadas da recursão: os nós internos
+// entram no caminho e as folhas são entregues direto do pai, sem serem lidas.
+typedef struct {
+    Fila *pendentes; //nós ainda não entregues (só em largura)
+    ModoPercurso modo;
+    nodo_t *raiz; //raiz ainda não entregue (NULL depois da primeira chamada)
+    nodo_t *caminho[ALTURA_MAXIMA]; //nós internos da raiz até o atual
+    int proximoFilho[ALTURA_MAXIMA]; //próximo filho a visitar em cada nível do caminho
+    char filhosFolhas[ALTURA_MAXIMA]; //1 se os filhos do nó do caminho são folhas
+    int profundidade; //último nível ocupado do caminho (-1 = vazio)
+    int ultimoNoCaminho; //1 se o último nó entregue está no topo do caminho
+} Percurso_t;
+
+// Funções Públicas (API da Fila)
+Fila* criarFila();
+void enfileirar(Fila* f, nodo_t* nodo_arvore);
+nodo_t* desenfileirar(Fila* f); //retira do início
+nodo_t* desempilhar(Fila* f); //retira do final
+int filaVazia(Fila* f);
+void destruirFila(Fila* f);
+
+// Percurso sem recursão. Só em PERCURSO_POS_ORDEM (ou em largura, que já enfileirou os
+// filhos) quem chama pode liberar o nó devolvido antes de pedir o próximo.
+void iniciarPercurso(Percurso_t *percurso, nodo_t *raiz, ModoPercurso modo);
+nodo_t *proximoNodoPendente(Percurso_t *percurso, int *nivel); //caminho lento de proximoNodo
+nodo_t *paiUltimoNodo(const Percurso_t *percurso, int *indice); //pai do último nó entregue e a posição dele entre os filhos (NULL para a raiz; só em profundidade)
+void encerrarPercurso(Percurso_t *percurso);
+
+// Traz para o cache o início do nó e o final, onde ficam numChaves e folha
+static inline void _prefetchNodo(const nodo_t* nodo) {
+    __builtin_prefetch(nodo);
+    __builtin_prefetch(&nodo->numChaves);
+}
+
+// Próximo nó e seu nível (raiz = 0), ou NULL no fim. A maior parte das chamadas entrega
+// uma folha do nó no topo do caminho, e essa parte fica aqui para ser expandida no laço
+// de quem chama; o resto (descer, subir, largura) fica em proximoNodoPendente.
+static inline nodo_t *proximoNodo(Percurso_t *percurso, int *nivel) {
+    int d = percurso->profundidade;
+    if (d >= 0 && percurso->filhosFolhas[d]) {
+        nodo_t *topo = percurso->caminho[d];
+        int i = percurso->proximoFilho[d];
+        if (i <= topo->numChaves) {
+            percurso->proximoFilho[d] = i + 1;
+            percurso->ultimoNoCaminho = 0;
+            // Como na fila em largura, o irmão entregue DISTANCIA_PREFETCH chamadas depois
+            if (i + DISTANCIA_PREFETCH <= topo->numChaves) {
+                _prefetchNodo(topo->filhos[i + DISTANCIA_PREFETCH]);
+            }
+            if (nivel != NULL) {
+                *nivel = d + 1;
+            }
+            return topo->filhos[i];
+        }
+    }
+    return proximoNodoPendente(percurso, nivel);
+}
+
+void imprimeArvorePorNiveis(nodo_t *raiz);
+
+#endif // FILA_H
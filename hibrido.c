@@ -0,0 +1,564 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "hibrido.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BYTES_CHAVE 8
+#define MARCA_ENTRADA ((uintptr_t)1) //bit baixo marca ponteiros para entradas (folhas da ART)
+
+// Cabeçalho comum: o prefixo guarda os bytes que todos os descendentes compartilham
+// abaixo deste nó (compressão de caminho); como a chave tem 8 bytes, cabe inteiro.
+typedef struct {
+    uint8_t tipo; //TipoNodoART
+    uint8_t tamPrefixo;
+    uint16_t numFilhos;
+    uint8_t prefixo[BYTES_CHAVE];
+} CabecalhoART;
+
+typedef struct {
+    CabecalhoART cabecalho;
+    uint8_t chaves[4]; //bytes dos filhos, em ordem crescente
+    void *filhos[4];
+} NodoART4;
+
+typedef struct {
+    CabecalhoART cabecalho;
+    uint8_t chaves[16]; //bytes dos filhos, em ordem crescente (comparados com SSE2)
+    void *filhos[16];
+} NodoART16;
+
+typedef struct {
+    CabecalhoART cabecalho;
+    uint8_t indice[256]; //posição + 1 do filho em 'filhos' (0 = sem filho)
+    void *filhos[48];
+} NodoART48;
+
+typedef struct {
+    CabecalhoART cabecalho;
+    void *filhos[256];
+} NodoART256;
+
+// Entrada da ART: limite inferior de uma folha da árvore B+
+typedef struct {
+    unsigned long long chave;
+    nodo_t *folha;
+} EntradaART;
+
+static const size_t tamanhosNodo[NUM_TIPOS_ART] = {sizeof(NodoART4), sizeof(NodoART16), sizeof(NodoART48), sizeof(NodoART256)};
+
+static inline int _ehEntrada(const void *no) {
+    return ((uintptr_t)no & MARCA_ENTRADA) != 0;
+}
+
+static inline EntradaART *_entrada(const void *no) {
+    return (EntradaART *)((uintptr_t)no & ~MARCA_ENTRADA);
+}
+
+// Byte da chave na profundidade indicada (0 = mais significativo)
+static inline uint8_t _byte(unsigned long long chave, int profundidade) {
+    return (uint8_t)(chave >> (8 * (BYTES_CHAVE - 1 - profundidade)));
+}
+
+// ====================================================================================
+// Nós
+// ====================================================================================
+
+static void *_novaEntrada(unsigned long long chave, nodo_t *folha) {
+    EntradaART *entrada = (EntradaART *)malloc(sizeof(EntradaART));
+    if (entrada == NULL) {
+        perror("Erro ao alocar entrada do índice híbrido");
+        exit(EXIT_FAILURE);
+    }
+    entrada->chave = chave;
+    entrada->folha = folha;
+    return (void *)((uintptr_t)entrada | MARCA_ENTRADA);
+}
+
+static CabecalhoART *_novoNodo(IndiceHibrido_t *indice, TipoNodoART tipo) {
+    CabecalhoART *nodo = (CabecalhoART *)calloc(1, tamanhosNodo[tipo]);
+    if (nodo == NULL) {
+        perror("Erro ao alocar nó do índice híbrido");
+        exit(EXIT_FAILURE);
+    }
+    nodo->tipo = tipo;
+    indice->numNodos[tipo]++;
+    return nodo;
+}
+
+// Posição do filho com o byte informado (NULL se não houver)
+static void **_encontrarFilho(CabecalhoART *nodo, uint8_t byte) {
+    switch (nodo->tipo) {
+        case ART_NODO4: {
+            NodoART4 *n = (NodoART4 *)nodo;
+            for (int i = 0; i < nodo->numFilhos; i++) {
+                if (n->chaves[i] == byte) {
+                    return &n->filhos[i];
+                }
+            }
+            return NULL;
+        }
+        case ART_NODO16: {
+            NodoART16 *n = (NodoART16 *)nodo;
+#if defined(__SSE2__)
+            __m128i iguais = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), _mm_loadu_si128((const __m128i *)n->chaves));
+            unsigned int mascara = (unsigned int)_mm_movemask_epi8(iguais) & ((1u << nodo->numFilhos) - 1);
+            return mascara ? &n->filhos[__builtin_ctz(mascara)] : NULL;
+#else
+            for (int i = 0; i < nodo->numFilhos; i++) {
+                if (n->chaves[i] == byte) {
+                    return &n->filhos[i];
+                }
+            }
+            return NULL;
+#endif
+        }
+        case ART_NODO48: {
+            NodoART48 *n = (NodoART48 *)nodo;
+            return n->indice[byte] ? &n->filhos[n->indice[byte] - 1] : NULL;
+        }
+        default: {
+            NodoART256 *n = (NodoART256 *)nodo;
+            return n->filhos[byte] ? &n->filhos[byte] : NULL;
+        }
+    }
+}
+
+// Quantos dos bytes ordenados são menores que 'byte'
+static int _contarMenores(const uint8_t *chaves, int quantidade, uint8_t byte) {
+#if defined(__SSE2__)
+    if (quantidade > 4) {
+        // Comparação sem sinal via inversão do bit de sinal
+        __m128i deslocamento = _mm_set1_epi8((char)0x80);
+        __m128i menores = _mm_cmplt_epi8(_mm_xor_si128(_mm_loadu_si128((const __m128i *)chaves), deslocamento),
+                                         _mm_xor_si128(_mm_set1_epi8((char)byte), deslocamento));
+        return __builtin_popcount((unsigned int)_mm_movemask_epi8(menores) & ((1u << quantidade) - 1));
+    }
+#endif
+    int i = 0;
+    while (i < quantidade && chaves[i] < byte) {
+        i++;
+    }
+    return i;
+}
+
+// Filho de maior byte menor que 'byte' (NULL se não houver)
+static void *_filhoAnterior(CabecalhoART *nodo, uint8_t byte) {
+    switch (nodo->tipo) {
+        case ART_NODO4: {
+            NodoART4 *n = (NodoART4 *)nodo;
+            int i = _contarMenores(n->chaves, nodo->numFilhos, byte);
+            return i > 0 ? n->filhos[i - 1] : NULL;
+        }
+        case ART_NODO16: {
+            NodoART16 *n = (NodoART16 *)nodo;
+            int i = _contarMenores(n->chaves, nodo->numFilhos, byte);
+            return i > 0 ? n->filhos[i - 1] : NULL;
+        }
+        case ART_NODO48: {
+            NodoART48 *n = (NodoART48 *)nodo;
+            for (int b = (int)byte - 1; b >= 0; b--) {
+                if (n->indice[b]) {
+                    return n->filhos[n->indice[b] - 1];
+                }
+            }
+            return NULL;
+        }
+        default: {
+            NodoART256 *n = (NodoART256 *)nodo;
+            for (int b = (int)byte - 1; b >= 0; b--) {
+                if (n->filhos[b]) {
+                    return n->filhos[b];
+                }
+            }
+            return NULL;
+        }
+    }
+}
+
+// Acrescenta um filho, trocando o nó por um maior quando está cheio
+static void _adicionarFilho(IndiceHibrido_t *indice, void **referencia, uint8_t byte, void *filho) {
+    CabecalhoART *nodo = (CabecalhoART *)*referencia;
+    switch (nodo->tipo) {
+        case ART_NODO4:
+        case ART_NODO16: {
+            int capacidade = nodo->tipo == ART_NODO4 ? 4 : 16;
+            uint8_t *chaves = nodo->tipo == ART_NODO4 ? ((NodoART4 *)nodo)->chaves : ((NodoART16 *)nodo)->chaves;
+            void **filhos = nodo->tipo == ART_NODO4 ? ((NodoART4 *)nodo)->filhos : ((NodoART16 *)nodo)->filhos;
+            if (nodo->numFilhos < capacidade) {
+                int pos = _contarMenores(chaves, nodo->numFilhos, byte);
+                memmove(chaves + pos + 1, chaves + pos, nodo->numFilhos - pos);
+                memmove(filhos + pos + 1, filhos + pos, (nodo->numFilhos - pos) * sizeof(void *));
+                chaves[pos] = byte;
+                filhos[pos] = filho;
+                nodo->numFilhos++;
+                return;
+            }
+            CabecalhoART *maior = _novoNodo(indice, nodo->tipo == ART_NODO4 ? ART_NODO16 : ART_NODO48);
+            memcpy(maior->prefixo, nodo->prefixo, BYTES_CHAVE);
+            maior->tamPrefixo = nodo->tamPrefixo;
+            maior->numFilhos = nodo->numFilhos;
+            if (maior->tipo == ART_NODO16) {
+                memcpy(((NodoART16 *)maior)->chaves, chaves, capacidade);
+                memcpy(((NodoART16 *)maior)->filhos, filhos, capacidade * sizeof(void *));
+            } else {
+                NodoART48 *n48 = (NodoART48 *)maior;
+                for (int i = 0; i < capacidade; i++) {
+                    n48->indice[chaves[i]] = (uint8_t)(i + 1);
+                    n48->filhos[i] = filhos[i];
+                }
+            }
+            indice->numNodos[nodo->tipo]--;
+            free(nodo);
+            *referencia = maior;
+            _adicionarFilho(indice, referencia, byte, filho);
+            return;
+        }
+        case ART_NODO48: {
+            NodoART48 *n = (NodoART48 *)nodo;
+            if (nodo->numFilhos < 48) {
+                // As posições ficam ocupadas em sequência (a remoção tapa o buraco com a última)
+                n->filhos[nodo->numFilhos] = filho;
+                n->indice[byte] = (uint8_t)(nodo->numFilhos + 1);
+                nodo->numFilhos++;
+                return;
+            }
+            NodoART256 *maior = (NodoART256 *)_novoNodo(indice, ART_NODO256);
+            memcpy(maior->cabecalho.prefixo, nodo->prefixo, BYTES_CHAVE);
+            maior->cabecalho.tamPrefixo = nodo->tamPrefixo;
+            maior->cabecalho.numFilhos = nodo->numFilhos;
+            for (int b = 0; b < 256; b++) {
+                if (n->indice[b]) {
+                    maior->filhos[b] = n->filhos[n->indice[b] - 1];
+                }
+            }
+            indice->numNodos[ART_NODO48]--;
+            free(nodo);
+            *referencia = maior;
+            _adicionarFilho(indice, referencia, byte, filho);
+            return;
+        }
+        default: {
+            NodoART256 *n = (NodoART256 *)nodo;
+            n->filhos[byte] = filho;
+            nodo->numFilhos++;
+            return;
+        }
+    }
+}
+
+// ====================================================================================
+// Inserção
+// ====================================================================================
+
+IndiceHibrido_t *criarIndiceHibrido(void) {
+    IndiceHibrido_t *indice = (IndiceHibrido_t *)calloc(1, sizeof(IndiceHibrido_t));
+    if (indice == NULL) {
+        perror("Erro ao alocar índice híbrido");
+        exit(EXIT_FAILURE);
+    }
+    indice->valido = 1;
+    return indice;
+}
+
+static void _inserir(IndiceHibrido_t *indice, void **referencia, unsigned long long chave, nodo_t *folha, int profundidade) {
+    void *no = *referencia;
+    if (no == NULL) {
+        *referencia = _novaEntrada(chave, folha);
+        indice->numEntradas++;
+        return;
+    }
+    if (_ehEntrada(no)) {
+        EntradaART *existente = _entrada(no);
+        if (existente->chave == chave) {
+            existente->folha = folha;
+            return;
+        }
+        // Duas chaves no mesmo lugar: um nó com o prefixo comum separa as duas
+        CabecalhoART *novo = _novoNodo(indice, ART_NODO4);
+        int comum = 0;
+        while (_byte(existente->chave, profundidade + comum) == _byte(chave, profundidade + comum)) {
+            novo->prefixo[comum] = _byte(chave, profundidade + comum);
+            comum++;
+        }
+        novo->tamPrefixo = (uint8_t)comum;
+        void *referenciaNovo = novo;
+        _adicionarFilho(indice, &referenciaNovo, _byte(existente->chave, profundidade + comum), no);
+        _adicionarFilho(indice, &referenciaNovo, _byte(chave, profundidade + comum), _novaEntrada(chave, folha));
+        indice->numEntradas++;
+        *referencia = referenciaNovo;
+        return;
+    }
+
+    CabecalhoART *nodo = (CabecalhoART *)no;
+    int igual = 0;
+    while (igual < nodo->tamPrefixo && nodo->prefixo[igual] == _byte(chave, profundidade + igual)) {
+        igual++;
+    }
+    if (igual < nodo->tamPrefixo) {
+        // A chave diverge no meio do prefixo: o nó ganha um pai com a parte comum
+        CabecalhoART *novo = _novoNodo(indice, ART_NODO4);
+        memcpy(novo->prefixo, nodo->prefixo, igual);
+        novo->tamPrefixo = (uint8_t)igual;
+        uint8_t byteAntigo = nodo->prefixo[igual];
+        memmove(nodo->prefixo, nodo->prefixo + igual + 1, nodo->tamPrefixo - igual - 1);
+        nodo->tamPrefixo = (uint8_t)(nodo->tamPrefixo - igual - 1);
+        void *referenciaNovo = novo;
+        _adicionarFilho(indice, &referenciaNovo, byteAntigo, nodo);
+        _adicionarFilho(indice, &referenciaNovo, _byte(chave, profundidade + igual), _novaEntrada(chave, folha));
+        indice->numEntradas++;
+        *referencia = referenciaNovo;
+        return;
+    }
+
+    profundidade += nodo->tamPrefixo;
+    void **filho = _encontrarFilho(nodo, _byte(chave, profundidade));
+    if (filho != NULL) {
+        _inserir(indice, filho, chave, folha, profundidade + 1);
+        return;
+    }
+    _adicionarFilho(indice, referencia, _byte(chave, profundidade), _novaEntrada(chave, folha));
+    indice->numEntradas++;
+}
+
+void inserirIndiceHibrido(IndiceHibrido_t *indice, unsigned long long limiteInferior, nodo_t *folha) {
+    _inserir(indice, &indice->raiz, limiteInferior, folha, 0);
+}
+
+// ====================================================================================
+// Remoção
+// ====================================================================================
+
+// Tira do nó o filho com o byte informado (que deve existir)
+static void _removerFilho(CabecalhoART *nodo, uint8_t byte) {
+    switch (nodo->tipo) {
+        case ART_NODO4:
+        case ART_NODO16: {
+            uint8_t *chaves = nodo->tipo == ART_NODO4 ? ((NodoART4 *)nodo)->chaves : ((NodoART16 *)nodo)->chaves;
+            void **filhos = nodo->tipo == ART_NODO4 ? ((NodoART4 *)nodo)->filhos : ((NodoART16 *)nodo)->filhos;
+            int pos = _contarMenores(chaves, nodo->numFilhos, byte);
+            memmove(chaves + pos, chaves + pos + 1, nodo->numFilhos - pos - 1);
+            memmove(filhos + pos, filhos + pos + 1, (nodo->numFilhos - pos - 1) * sizeof(void *));
+            break;
+        }
+        case ART_NODO48: {
+            NodoART48 *n = (NodoART48 *)nodo;
+            int posicao = n->indice[byte] - 1, ultima = nodo->numFilhos - 1;
+            n->indice[byte] = 0;
+            if (posicao != ultima) {
+                n->filhos[posicao] = n->filhos[ultima];
+                for (int b = 0; b < 256; b++) {
+                    if (n->indice[b] == ultima + 1) {
+                        n->indice[b] = (uint8_t)(posicao + 1);
+                        break;
+                    }
+                }
+            }
+            break;
+        }
+        default:
+            ((NodoART256 *)nodo)->filhos[byte] = NULL;
+            break;
+    }
+    nodo->numFilhos--;
+}
+
+// Único filho de um nó e o seu byte. O byte é sempre escrito, para o chamador nunca
+// ler lixo mesmo nos tipos em que o filho é procurado por varredura.
+static void *_unicoFilho(CabecalhoART *nodo, uint8_t *byte) {
+    *byte = 0;
+    switch (nodo->tipo) {
+        case ART_NODO4:
+            *byte = ((NodoART4 *)nodo)->chaves[0];
+            return ((NodoART4 *)nodo)->filhos[0];
+        case ART_NODO16:
+            *byte = ((NodoART16 *)nodo)->chaves[0];
+            return ((NodoART16 *)nodo)->filhos[0];
+        case ART_NODO48: {
+            NodoART48 *n = (NodoART48 *)nodo;
+            for (int b = 0; b < 256; b++) {
+                if (n->indice[b]) {
+                    *byte = (uint8_t)b;
+                    return n->filhos[n->indice[b] - 1];
+                }
+            }
+            return NULL;
+        }
+        default: {
+            NodoART256 *n = (NodoART256 *)nodo;
+            for (int b = 0; b < 256; b++) {
+                if (n->filhos[b]) {
+                    *byte = (uint8_t)b;
+                    return n->filhos[b];
+                }
+            }
+            return NULL;
+        }
+    }
+}
+
+// Remove a entrada da chave. Um nó que fica com um só filho é trocado por ele; se o
+// filho for um nó, herda o prefixo do pai e o byte que os ligava (cabe nos 8 bytes,
+// pois a profundidade não muda). Os nós não voltam para um tipo menor.
+static void _removerEntrada(IndiceHibrido_t *indice, void **referencia, unsigned long long chave, int profundidade, int *removida) {
+    void *no = *referencia;
+    if (_ehEntrada(no)) {
+        if (_entrada(no)->chave == chave) {
+            free(_entrada(no));
+            *referencia = NULL;
+            indice->numEntradas--;
+            *removida = 1;
+        }
+        return;
+    }
+    CabecalhoART *nodo = (CabecalhoART *)no;
+    for (int i = 0; i < nodo->tamPrefixo; i++) {
+        if (nodo->prefixo[i] != _byte(chave, profundidade + i)) {
+            return;
+        }
+    }
+    uint8_t byte = _byte(chave, profundidade + nodo->tamPrefixo);
+    void **filho = _encontrarFilho(nodo, byte);
+    if (filho == NULL) {
+        return;
+    }
+    _removerEntrada(indice, filho, chave, profundidade + nodo->tamPrefixo + 1, removida);
+    if (*filho != NULL) {
+        return;
+    }
+    _removerFilho(nodo, byte);
+    if (nodo->numFilhos > 1) {
+        return;
+    }
+    uint8_t byteFilho = 0;
+    void *unico = _unicoFilho(nodo, &byteFilho);
+    if (unico != NULL && !_ehEntrada(unico)) {
+        CabecalhoART *neto = (CabecalhoART *)unico;
+        uint8_t prefixo[BYTES_CHAVE];
+        int tamanho = nodo->tamPrefixo;
+        memcpy(prefixo, nodo->prefixo, tamanho);
+        prefixo[tamanho++] = byteFilho;
+        memcpy(prefixo + tamanho, neto->prefixo, neto->tamPrefixo);
+        tamanho += neto->tamPrefixo;
+        memcpy(neto->prefixo, prefixo, tamanho);
+        neto->tamPrefixo = (uint8_t)tamanho;
+    }
+    indice->numNodos[nodo->tipo]--;
+    free(nodo);
+    *referencia = unico;
+}
+
+int removerIndiceHibrido(IndiceHibrido_t *indice, unsigned long long limiteInferior) {
+    int removida = 0;
+    if (indice->raiz != NULL) {
+        _removerEntrada(indice, &indice->raiz, limiteInferior, 0, &removida);
+    }
+    return removida;
+}
+
+// ====================================================================================
+// Busca
+// ====================================================================================
+
+// Entrada de maior chave da subárvore
+static EntradaART *_maximo(void *no) {
+    while (!_ehEntrada(no)) {
+        CabecalhoART *nodo = (CabecalhoART *)no;
+        void **ultimo = _encontrarFilho(nodo, 255);
+        no = ultimo != NULL ? *ultimo : _filhoAnterior(nodo, 255);
+    }
+    return _entrada(no);
+}
+
+// Entrada de maior chave <= 'chave' na subárvore. Desce pelos bytes da chave e, se o
+// ramo exato não tiver candidata, volta para o irmão anterior mais próximo.
+static EntradaART *_predecessor(void *no, unsigned long long chave, int profundidade) {
+    if (_ehEntrada(no)) {
+        EntradaART *entrada = _entrada(no);
+        return entrada->chave <= chave ? entrada : NULL;
+    }
+    CabecalhoART *nodo = (CabecalhoART *)no;
+    for (int i = 0; i < nodo->tamPrefixo; i++) {
+        uint8_t byte = _byte(chave, profundidade + i);
+        if (byte != nodo->prefixo[i]) {
+            // Toda a subárvore é maior (sem candidata) ou menor (a maior delas serve)
+            return byte < nodo->prefixo[i] ? NULL : _maximo(no);
+        }
+    }
+    profundidade += nodo->tamPrefixo;
+    uint8_t byte = _byte(chave, profundidade);
+    void **filho = _encontrarFilho(nodo, byte);
+    if (filho != NULL) {
+        EntradaART *resultado = _predecessor(*filho, chave, profundidade + 1);
+        if (resultado != NULL) {
+            return resultado;
+        }
+    }
+    void *anterior = _filhoAnterior(nodo, byte);
+    return anterior != NULL ? _maximo(anterior) : NULL;
+}
+
+nodo_t *rotearIndiceHibrido(const IndiceHibrido_t *indice, unsigned long long chave) {
+    if (indice->raiz == NULL) {
+        return NULL;
+    }
+    EntradaART *entrada = _predecessor(indice->raiz, chave, 0);
+    return entrada != NULL ? entrada->folha : NULL;
+}
+
+// ====================================================================================
+// Liberação e Memória
+// ====================================================================================
+
+static void _liberar(void *no) {
+    if (no == NULL) {
+        return;
+    }
+    if (_ehEntrada(no)) {
+        free(_entrada(no));
+        return;
+    }
+    CabecalhoART *nodo = (CabecalhoART *)no;
+    switch (nodo->tipo) {
+        case ART_NODO4:
+            for (int i = 0; i < nodo->numFilhos; i++) {
+                _liberar(((NodoART4 *)nodo)->filhos[i]);
+            }
+            break;
+        case ART_NODO16:
+            for (int i = 0; i < nodo->numFilhos; i++) {
+                _liberar(((NodoART16 *)nodo)->filhos[i]);
+            }
+            break;
+        case ART_NODO48:
+            for (int i = 0; i < nodo->numFilhos; i++) {
+                _liberar(((NodoART48 *)nodo)->filhos[i]);
+            }
+            break;
+        default:
+            for (int b = 0; b < 256; b++) {
+                _liberar(((NodoART256 *)nodo)->filhos[b]);
+            }
+            break;
+    }
+    free(nodo);
+}
+
+void destruirIndiceHibrido(IndiceHibrido_t *indice) {
+    if (indice == NULL) {
+        return;
+    }
+    _liberar(indice->raiz);
+    free(indice);
+}
+
+size_t memoriaIndiceHibrido(const IndiceHibrido_t *indice) {
+    size_t total = indice->numEntradas * sizeof(EntradaART);
+    for (int t = 0; t < NUM_TIPOS_ART; t++) {
+        total += indice->numNodos[t] * tamanhosNodo[t];
+    }
+    return total;
+}
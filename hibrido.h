@@ -0,0 +1,34 @@
+#ifndef HIBRIDO_H
+#define HIBRIDO_H
+
+#include "BPlusTree.h"
+
+// Tipos de nó da árvore radix adaptativa (ART), pelo número máximo de filhos
+typedef enum {
+    ART_NODO4,
+    ART_NODO16,
+    ART_NODO48,
+    ART_NODO256,
+    NUM_TIPOS_ART
+} TipoNodoART;
+
+// Índice híbrido: uma ART sobre os bytes da chave (do mais significativo ao menos)
+// mantida ao lado dos níveis internos da árvore B+, que continuam existindo e sendo
+// atualizados; a ART só atalha a descida, ao custo de memória. Cada entrada associa o limite
+// inferior de uma folha à própria folha; a busca devolve a folha de maior limite
+// menor ou igual à chave, e dali em diante valem as folhas e o encadeamento.
+typedef struct IndiceHibrido {
+    void *raiz; //nó da ART ou entrada (ponteiro marcado)
+    long numEntradas; //folhas da árvore B+ indexadas
+    long numNodos[NUM_TIPOS_ART]; //nós internos da ART de cada tipo
+    int valido; //0 enquanto a árvore muda de um jeito que a ART não acompanha
+} IndiceHibrido_t;
+
+IndiceHibrido_t *criarIndiceHibrido(void);
+void destruirIndiceHibrido(IndiceHibrido_t *indice);
+void inserirIndiceHibrido(IndiceHibrido_t *indice, unsigned long long limiteInferior, nodo_t *folha); //substitui a folha se o limite já existir
+int removerIndiceHibrido(IndiceHibrido_t *indice, unsigned long long limiteInferior); //1 se o limite estava indexado
+nodo_t *rotearIndiceHibrido(const IndiceHibrido_t *indice, unsigned long long chave); //folha de maior limite <= chave (NULL se não houver)
+size_t memoriaIndiceHibrido(const IndiceHibrido_t *indice); //bytes ocupados pela ART
+
+#endif // HIBRIDO_H
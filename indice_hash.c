@@ -0,0 +1,265 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "indice_hash.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define VAZIO_HASH 0x00 //nunca usada: a sondagem para no primeiro grupo com uma destas
+#define APAGADO_HASH 0x01 //removida: a sondagem continua, mas a posição pode ser reutilizada
+#define OCUPADO_HASH 0x80 //bit alto marca posição ocupada; os 7 bits baixos vêm do hash
+#define CAPACIDADE_MINIMA_HASH 64
+#define GRUPOS_MIGRADOS_POR_PASSO 4 //trabalho de migração feito por inserção ou remoção
+
+// Mistura os bits da chave (finalizador do splitmix64, como no filtro de Bloom):
+// os 7 bits baixos vão para o byte de controle e os demais escolhem o grupo
+static unsigned long long _misturar(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// ====================================================================================
+// Grupos de controle (SSE2 com alternativa escalar)
+// ====================================================================================
+
+// Máscara das posições do grupo cujo byte de controle é igual a 'byte'
+static inline unsigned int _casarByte(const uint8_t *grupo, uint8_t byte) {
+#if defined(__SSE2__)
+    __m128i iguais = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), _mm_loadu_si128((const __m128i *)grupo));
+    return (unsigned int)_mm_movemask_epi8(iguais);
+#else
+    unsigned int mascara = 0;
+    for (int i = 0; i < TAM_GRUPO_HASH; i++) {
+        mascara |= (unsigned int)(grupo[i] == byte) << i;
+    }
+    return mascara;
+#endif
+}
+
+// Máscara das posições ocupadas (bit alto do byte de controle)
+static inline unsigned int _ocupadas(const uint8_t *grupo) {
+#if defined(__SSE2__)
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)grupo));
+#else
+    unsigned int mascara = 0;
+    for (int i = 0; i < TAM_GRUPO_HASH; i++) {
+        mascara |= (unsigned int)(grupo[i] >> 7) << i;
+    }
+    return mascara;
+#endif
+}
+
+// ====================================================================================
+// Operações sobre uma tabela
+// ====================================================================================
+
+// Os bytes de controle vêm do calloc: para tabelas grandes são páginas zeradas sob
+// demanda, então criar a tabela nova não custa uma passada por ela
+static void _alocarTabela(TabelaHash_t *tabela, size_t capacidade) {
+    tabela->controle = (uint8_t *)calloc(capacidade, 1);
+    tabela->entradas = (EntradaHash_t *)malloc(capacidade * sizeof(EntradaHash_t));
+    if (tabela->controle == NULL || tabela->entradas == NULL) {
+        perror("Erro ao alocar tabela de espalhamento");
+        exit(EXIT_FAILURE);
+    }
+    tabela->capacidade = capacidade;
+    tabela->numElementos = 0;
+    tabela->numApagados = 0;
+}
+
+static void _liberarTabela(TabelaHash_t *tabela) {
+    free(tabela->controle);
+    free(tabela->entradas);
+    memset(tabela, 0, sizeof(TabelaHash_t));
+}
+
+// Sondagem triangular entre grupos (1, 2, 3... grupos adiante): com um número de
+// grupos potência de 2 ela passa por todos. Devolve a entrada e a sua posição.
+static EntradaHash_t *_procurar(const TabelaHash_t *tabela, unsigned long long chave, unsigned long long hash, size_t *posicao) {
+    if (tabela->capacidade == 0) {
+        return NULL;
+    }
+    size_t mascaraGrupos = tabela->capacidade / TAM_GRUPO_HASH - 1;
+    size_t grupo = (hash >> 7) & mascaraGrupos;
+    uint8_t marca = OCUPADO_HASH | (hash & 0x7F);
+    for (size_t passo = 1;; passo++) {
+        size_t base = grupo * TAM_GRUPO_HASH;
+        __builtin_prefetch(&tabela->entradas[base]);
+        const uint8_t *controle = tabela->controle + base;
+        for (unsigned int candidatas = _casarByte(controle, marca); candidatas != 0; candidatas &= candidatas - 1) {
+            size_t i = base + __builtin_ctz(candidatas);
+            if (tabela->entradas[i].chave == chave) {
+                if (posicao != NULL) {
+                    *posicao = i;
+                }
+                return &tabela->entradas[i];
+            }
+        }
+        if (_casarByte(controle, VAZIO_HASH) != 0) {
+            return NULL;
+        }
+        grupo = (grupo + passo) & mascaraGrupos;
+    }
+}
+
+// Coloca uma chave ausente na primeira posição livre (vazia ou apagada) da sondagem
+static void _colocar(TabelaHash_t *tabela, unsigned long long hash, unsigned long long chave, registro_t *registro) {
+    size_t mascaraGrupos = tabela->capacidade / TAM_GRUPO_HASH - 1;
+    size_t grupo = (hash >> 7) & mascaraGrupos;
+    for (size_t passo = 1;; passo++) {
+        size_t base = grupo * TAM_GRUPO_HASH;
+        unsigned int livres = ~_ocupadas(tabela->controle + base) & 0xFFFFu;
+        if (livres != 0) {
+            size_t i = base + __builtin_ctz(livres);
+            if (tabela->controle[i] == APAGADO_HASH) {
+                tabela->numApagados--;
+            }
+            tabela->controle[i] = OCUPADO_HASH | (hash & 0x7F);
+            tabela->entradas[i].chave = chave;
+            tabela->entradas[i].registro = registro;
+            tabela->numElementos++;
+            return;
+        }
+        grupo = (grupo + passo) & mascaraGrupos;
+    }
+}
+
+// Se o grupo ainda tem uma posição vazia, nenhuma sondagem passou dele e a posição
+// pode voltar a ser vazia; senão vira marca de remoção para não cortar as sondagens
+static void _apagar(TabelaHash_t *tabela, size_t posicao) {
+    const uint8_t *grupo = tabela->controle + (posicao & ~(size_t)(TAM_GRUPO_HASH - 1));
+    if (_casarByte(grupo, VAZIO_HASH) != 0) {
+        tabela->controle[posicao] = VAZIO_HASH;
+    } else {
+        tabela->controle[posicao] = APAGADO_HASH;
+        tabela->numApagados++;
+    }
+    tabela->numElementos--;
+}
+
+// ====================================================================================
+// Redimensionamento incremental
+// ====================================================================================
+
+// Move alguns grupos da tabela antiga para a atual. As posições migradas viram
+// marcas de remoção na antiga, para as sondagens que passam por elas continuarem.
+static void _migrarPasso(IndiceHash_t *indice) {
+    TabelaHash_t *antiga = &indice->antiga;
+    if (antiga->capacidade == 0) {
+        return;
+    }
+    size_t numGrupos = antiga->capacidade / TAM_GRUPO_HASH;
+    for (int k = 0; k < GRUPOS_MIGRADOS_POR_PASSO && indice->proximoGrupoMigrar < numGrupos; k++) {
+        size_t base = indice->proximoGrupoMigrar++ * TAM_GRUPO_HASH;
+        for (unsigned int ocupadas = _ocupadas(antiga->controle + base); ocupadas != 0; ocupadas &= ocupadas - 1) {
+            size_t i = base + __builtin_ctz(ocupadas);
+            EntradaHash_t *entrada = &antiga->entradas[i];
+            _colocar(&indice->atual, _misturar(entrada->chave), entrada->chave, entrada->registro);
+            antiga->controle[i] = APAGADO_HASH;
+            antiga->numElementos--;
+        }
+    }
+    if (indice->proximoGrupoMigrar == numGrupos) {
+        _liberarTabela(antiga);
+        indice->proximoGrupoMigrar = 0;
+    }
+}
+
+// A tabela cheia (7/8 contando as marcas de remoção) passa a ser a antiga. A nova tem
+// o dobro do tamanho, ou o mesmo se a maior parte da ocupação for de marcas. Com
+// GRUPOS_MIGRADOS_POR_PASSO a migração termina muito antes de a nova encher.
+static void _iniciarRedimensionamento(IndiceHash_t *indice) {
+    while (indice->antiga.capacidade != 0) {
+        _migrarPasso(indice);
+    }
+    size_t capacidade = indice->atual.capacidade;
+    if (indice->atual.numElementos + 1 > capacidade / 16 * 7) {
+        capacidade *= 2;
+    }
+    indice->antiga = indice->atual;
+    _alocarTabela(&indice->atual, capacidade);
+    indice->proximoGrupoMigrar = 0;
+    indice->numRedimensionamentos++;
+}
+
+// ====================================================================================
+// Interface do índice
+// ====================================================================================
+
+IndiceHash_t *criarIndiceHash(long capacidade) {
+    IndiceHash_t *indice = (IndiceHash_t *)calloc(1, sizeof(IndiceHash_t));
+    if (indice == NULL) {
+        perror("Erro ao alocar índice de espalhamento");
+        exit(EXIT_FAILURE);
+    }
+    size_t posicoes = CAPACIDADE_MINIMA_HASH;
+    while (posicoes / 8 * 7 < (size_t)capacidade) {
+        posicoes *= 2;
+    }
+    _alocarTabela(&indice->atual, posicoes);
+    return indice;
+}
+
+void destruirIndiceHash(IndiceHash_t *indice) {
+    if (indice == NULL) {
+        return;
+    }
+    _liberarTabela(&indice->atual);
+    _liberarTabela(&indice->antiga);
+    free(indice);
+}
+
+registro_t *buscarIndiceHash(const IndiceHash_t *indice, unsigned long long chave) {
+    unsigned long long hash = _misturar(chave);
+    EntradaHash_t *entrada = _procurar(&indice->atual, chave, hash, NULL);
+    if (entrada == NULL) {
+        entrada = _procurar(&indice->antiga, chave, hash, NULL);
+    }
+    return entrada != NULL ? entrada->registro : NULL;
+}
+
+void inserirIndiceHash(IndiceHash_t *indice, registro_t *registro) {
+    unsigned long long hash = _misturar(registro->chave);
+    EntradaHash_t *entrada = _procurar(&indice->atual, registro->chave, hash, NULL);
+    if (entrada == NULL) {
+        entrada = _procurar(&indice->antiga, registro->chave, hash, NULL);
+    }
+    if (entrada != NULL) {
+        entrada->registro = registro;
+        return;
+    }
+    TabelaHash_t *atual = &indice->atual;
+    if (atual->numElementos + atual->numApagados + 1 > atual->capacidade / 8 * 7) {
+        _iniciarRedimensionamento(indice);
+    }
+    _colocar(&indice->atual, hash, registro->chave, registro);
+    _migrarPasso(indice);
+}
+
+int removerIndiceHash(IndiceHash_t *indice, unsigned long long chave) {
+    unsigned long long hash = _misturar(chave);
+    size_t posicao;
+    int removida = 1;
+    if (_procurar(&indice->atual, chave, hash, &posicao) != NULL) {
+        _apagar(&indice->atual, posicao);
+    } else if (_procurar(&indice->antiga, chave, hash, &posicao) != NULL) {
+        _apagar(&indice->antiga, posicao);
+    } else {
+        removida = 0;
+    }
+    _migrarPasso(indice);
+    return removida;
+}
+
+long elementosIndiceHash(const IndiceHash_t *indice) {
+    return (long)(indice->atual.numElementos + indice->antiga.numElementos);
+}
+
+size_t memoriaIndiceHash(const IndiceHash_t *indice) {
+    size_t posicoes = indice->atual.capacidade + indice->antiga.capacidade;
+    return sizeof(IndiceHash_t) + posicoes * (1 + sizeof(EntradaHash_t));
+}
@@ -0,0 +1,43 @@
+#ifndef INDICE_HASH_H
+#define INDICE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BPlusTree.h"
+
+#define TAM_GRUPO_HASH 16 //posições comparadas de uma vez (um registrador SSE2)
+
+//posição da tabela: a chave fica junto do ponteiro para a comparação não buscar o registro
+typedef struct {
+    unsigned long long chave;
+    registro_t *registro;
+} EntradaHash_t;
+
+//tabela de endereçamento aberto no estilo Swiss table: um byte de controle por
+//posição (vazia, apagada ou 7 bits do hash) e sondagem por grupos de 16 posições
+typedef struct {
+    uint8_t *controle; //bytes de controle (zerados = vazios)
+    EntradaHash_t *entradas; //chave e registro de cada posição
+    size_t capacidade; //posições (potência de 2, múltipla de TAM_GRUPO_HASH; 0 = sem tabela)
+    size_t numElementos; //posições ocupadas
+    size_t numApagados; //marcas de remoção (contam na ocupação até a próxima reconstrução)
+} TabelaHash_t;
+
+//índice chave -> registro com redimensionamento incremental: ao crescer, a tabela
+//antiga é mantida e esvaziada aos poucos a cada inserção ou remoção
+typedef struct IndiceHash {
+    TabelaHash_t atual; //recebe todas as inserções
+    TabelaHash_t antiga; //em migração para 'atual' (capacidade 0 quando não há)
+    size_t proximoGrupoMigrar; //primeiro grupo da tabela antiga ainda não migrado
+    long numRedimensionamentos; //tabelas novas criadas desde a criação do índice
+} IndiceHash_t;
+
+IndiceHash_t *criarIndiceHash(long capacidade); //já dimensionado para 'capacidade' chaves sem redimensionar
+void destruirIndiceHash(IndiceHash_t *indice); //não libera os registros
+registro_t *buscarIndiceHash(const IndiceHash_t *indice, unsigned long long chave); //NULL se ausente
+void inserirIndiceHash(IndiceHash_t *indice, registro_t *registro); //substitui o registro se a chave já existir
+int removerIndiceHash(IndiceHash_t *indice, unsigned long long chave); //1 se a chave estava no índice
+long elementosIndiceHash(const IndiceHash_t *indice); //chaves indexadas
+size_t memoriaIndiceHash(const IndiceHash_t *indice); //bytes das tabelas (inclusive a antiga, durante a migração)
+
+#endif // INDICE_HASH_H
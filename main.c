@@ -4,11 +4,48 @@
 #include <time.h> 
 #include "BPlusTree.h"
 #include "fila.h"
+#include "congelada.h"
+#include "particionada.h"
+#include "chaves_genericas.h"
+#include "arvore_string.h"
+#include "bloom.h"
+#include "carga.h"
+#include "hibrido.h"
+#include "varredura.h"
+#include "indice_hash.h"
 
 #define MAX_LINHA 256
+#define NUM_BUSCAS 100
+#define REPETICOES_CONGELADA 20
+#define INTERVALO_SNAPSHOT 100
+#define MAX_SNAPSHOTS_ATIVOS 4
+#define NUM_OPERACOES_PARTICIONADA 200000
+#define TAM_LOTE_PARTICIONADA 1024
+#define NUM_CHAVES_GENERICAS 200000
+#define TAM_PLACA 8
+#define NUM_REGISTROS_VARREDURA 1000000
+#define REPETICOES_VARREDURA 5
+#define NUM_CONSULTAS_ESTATISTICAS 1000
+#define NUM_BUSCAS_NEGATIVAS 200000
+#define NUM_REGISTROS_DIVISAO 500000
+#define NUM_REGISTROS_COMPACTACAO 500000
+#define GRUPOS_POR_PASSO 64 //grupos de ORDEM folhas visitados em cada passo da compactação
+#define INSERCOES_ENTRE_PASSOS 16 //tráfego simulado entre dois passos
+#define OCUPACAO_ALVO 90 //porcentagem de ocupação desejada nas folhas
+#define SEMENTE_CARGA 42 //semente fixa: a mesma carga em todas as execuções
+#define NUM_OPERACOES_CARGA 200000
+#define NUM_REGISTROS_PERCURSO 1000000 //10000000 reproduz o cenário de 10M registros (cerca de 2 GB de memória)
+#define NUM_BUSCAS_HIBRIDO 1000000
+#define NUM_VARREDURAS_HIBRIDO 1000
+#define REGISTROS_POR_VARREDURA 100 //tamanho médio de cada intervalo conferido
+#define NUM_INSERCOES_HIBRIDO 100000
+#define NUM_REGISTROS_VARREDURA_PARALELA 2000000
+#define REPETICOES_VARREDURA_PARALELA 3
+#define NUM_BUSCAS_HASH 1000000
 
 // Carrega registros de um arquivo para a árvore.
-void carregarRegistros(const char *nomeArquivo, BPlusTree_t *arvore, int numRegistros, unsigned long long *chaves) {
+// Retorna a quantidade de registros lidos.
+int carregarRegistros(const char *nomeArquivo, BPlusTree_t *arvore, int numRegistros, unsigned long long *chaves) {
     FILE *arquivo = fopen(nomeArquivo, "r");
     if (!arquivo) {
         perror("Erro ao abrir o arquivo para carregar registros");
@@ -27,6 +64,9 @@ void carregarRegistros(const char *nomeArquivo, BPlusTree_t *arvore, int numRegi
 
         if (sscanf(linha, "%llu,%19[^,],%d,%19[^,]", &chave, modelo, &ano, cor) == 4) {
              registro_t *registro = criarRegistro(chave, modelo, ano, cor);
+             if (registro == NULL) {
+                 continue;
+             }
              inserir(arvore, registro);
              if (chaves != NULL) {
                  chaves[count] = chave;
@@ -35,18 +75,15 @@ void carregarRegistros(const char *nomeArquivo, BPlusTree_t *arvore, int numRegi
         }
     }
     fclose(arquivo);
+    return count;
 }
 
-// Testa o desempenho da busca lendo chaves do arquivo 'buscas.txt'.
-// O número de buscas é fixo em 100 
-void testarDesempenhoBusca(BPlusTree_t *arvore, int totalRegistros) {
-    const int NUM_BUSCAS = 100; 
-    unsigned long long chavesParaBuscar[NUM_BUSCAS];
-
+// Lê até NUM_BUSCAS chaves do arquivo 'buscas.txt'. Retorna a quantidade lida.
+int lerChavesBusca(unsigned long long *chavesParaBuscar) {
     FILE* f_buscas = fopen("buscas.txt", "r");
     if (!f_buscas) {
         perror("ERRO: Não foi possível abrir 'buscas.txt'. Execute 'python gerar_testes_busca.py' primeiro");
-        return;
+        return 0;
     }
 
     int chavesLidas = 0;
@@ -57,7 +94,50 @@ void testarDesempenhoBusca(BPlusTree_t *arvore, int totalRegistros) {
         chavesLidas++;
     }
     fclose(f_buscas);
+    return chavesLidas;
+}
 
+// Lê registros do arquivo para um vetor, sem inseri-los em árvore.
+registro_t **lerRegistros(const char *nomeArquivo, int numRegistros, int *lidos) {
+    FILE *arquivo = fopen(nomeArquivo, "r");
+    if (!arquivo) {
+        perror("Erro ao abrir o arquivo para ler registros");
+        exit(EXIT_FAILURE);
+    }
+    registro_t **registros = (registro_t **)malloc(numRegistros * sizeof(registro_t *));
+    if (registros == NULL) {
+        perror("Erro ao alocar vetor de registros");
+        exit(EXIT_FAILURE);
+    }
+
+    char linha[MAX_LINHA];
+    int count = 0;
+    while (fgets(linha, sizeof(linha), arquivo) && count < numRegistros) {
+        unsigned long long chave;
+        int ano;
+        char modelo[TAM_MODELO] = {0};
+        char cor[TAM_COR] = {0};
+
+        linha[strcspn(linha, "\n")] = 0;
+
+        if (sscanf(linha, "%llu,%19[^,],%d,%19[^,]", &chave, modelo, &ano, cor) == 4) {
+            registro_t *registro = criarRegistro(chave, modelo, ano, cor);
+            if (registro != NULL) {
+                registros[count++] = registro;
+            }
+        }
+    }
+    fclose(arquivo);
+    *lidos = count;
+    return registros;
+}
+
+// Testa o desempenho da busca lendo chaves do arquivo 'buscas.txt'.
+// O número de buscas é fixo em 100 
+void testarDesempenhoBusca(BPlusTree_t *arvore, int totalRegistros) {
+    unsigned long long chavesParaBuscar[NUM_BUSCAS];
+
+    int chavesLidas = lerChavesBusca(chavesParaBuscar);
     if (chavesLidas == 0) {
         fprintf(stderr, "AVISO: Nenhuma chave lida de 'buscas.txt'. Teste de desempenho de busca cancelado.\n");
         return;
@@ -78,6 +158,1126 @@ void testarDesempenhoBusca(BPlusTree_t *arvore, int totalRegistros) {
            ORDEM, totalRegistros, chavesLidas, tempoTotal, tempoMedio);
 }
 
+// Compara a busca na árvore B+ com a busca na versão congelada (layout BFS).
+// Todas as chaves carregadas são buscadas em ordem aleatória, REPETICOES_CONGELADA vezes.
+void testarDesempenhoCongelada(BPlusTree_t *arvore, unsigned long long *chaves, int numChaves) {
+    if (numChaves == 0) {
+        return;
+    }
+    for (int i = numChaves - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        unsigned long long tmp = chaves[i];
+        chaves[i] = chaves[j];
+        chaves[j] = tmp;
+    }
+
+    clock_t inicio = clock();
+    ArvoreCongelada_t *congelada = congelarArvore(arvore);
+    clock_t fim = clock();
+    double tempoCongelamento = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+
+    long encontradosArvore = 0;
+    inicio = clock();
+    for (int r = 0; r < REPETICOES_CONGELADA; r++) {
+        for (int i = 0; i < numChaves; i++) {
+            encontradosArvore += (buscar(arvore, chaves[i]) != NULL);
+        }
+    }
+    fim = clock();
+    double tempoArvore = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+
+    long encontradosCongelada = 0;
+    inicio = clock();
+    for (int r = 0; r < REPETICOES_CONGELADA; r++) {
+        for (int i = 0; i < numChaves; i++) {
+            encontradosCongelada += (buscarCongelada(congelada, chaves[i]) != NULL);
+        }
+    }
+    fim = clock();
+    double tempoCongelada = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+
+    long totalBuscas = (long)numChaves * REPETICOES_CONGELADA;
+    printf("ORDEM: %-3d | Registros Inseridos: %-6d | Congelamento: %.6f segundos | Busca B+: %.10f s/busca | Busca Congelada: %.10f s/busca | Encontrados: %ld/%ld\n",
+           ORDEM, numChaves, tempoCongelamento, tempoArvore / totalBuscas, tempoCongelada / totalBuscas,
+           encontradosCongelada / REPETICOES_CONGELADA, encontradosArvore / REPETICOES_CONGELADA);
+
+    destruirArvoreCongelada(congelada);
+}
+
+// Mede o custo da inserção com snapshots ativos: um snapshot é criado a cada
+// INTERVALO_SNAPSHOT inserções e no máximo MAX_SNAPSHOTS_ATIVOS ficam vivos ao mesmo tempo.
+void testarDesempenhoSnapshot(const char *nomeArquivo, int numRegistros) {
+    int lidos;
+
+    // Referência: inserção sem snapshots
+    registro_t **registros = lerRegistros(nomeArquivo, numRegistros, &lidos);
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    clock_t inicio = clock();
+    for (int i = 0; i < lidos; i++) {
+        inserir(arvore, registros[i]);
+    }
+    clock_t fim = clock();
+    double tempoSemSnapshot = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+    int nodosBase = contarNodosArvore(arvore);
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+    free(registros);
+
+    // Inserção com snapshots ativos
+    registros = lerRegistros(nomeArquivo, numRegistros, &lidos);
+    arvore = criarArvoreBPlus();
+    Snapshot_t *ativos[MAX_SNAPSHOTS_ATIVOS] = {NULL};
+    int registrosNoSnapshot[MAX_SNAPSHOTS_ATIVOS] = {0};
+    int proximoSlot = 0;
+    long picoVersoes = 0;
+
+    inicio = clock();
+    for (int i = 0; i < lidos; i++) {
+        if (i % INTERVALO_SNAPSHOT == 0) {
+            liberarSnapshot(ativos[proximoSlot]);
+            ativos[proximoSlot] = criarSnapshot(arvore);
+            registrosNoSnapshot[proximoSlot] = i;
+            proximoSlot = (proximoSlot + 1) % MAX_SNAPSHOTS_ATIVOS;
+        }
+        inserir(arvore, registros[i]);
+        if (arvore->nodosVersoes > picoVersoes) {
+            picoVersoes = arvore->nodosVersoes;
+        }
+    }
+    fim = clock();
+    double tempoComSnapshot = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+
+    // Confere que cada snapshot ainda enxerga exatamente os registros do seu instante
+    int consistentes = 0, totalSnapshots = 0;
+    for (int s = 0; s < MAX_SNAPSHOTS_ATIVOS; s++) {
+        if (ativos[s] == NULL) {
+            continue;
+        }
+        CursorSnapshot_t cursor;
+        int contagem = 0;
+        for (nodo_t *folha = primeiraFolhaSnapshot(ativos[s], &cursor); folha != NULL; folha = proximaFolhaSnapshot(&cursor)) {
+            contagem += folha->numChaves;
+        }
+        consistentes += (contagem == registrosNoSnapshot[s]);
+        totalSnapshots++;
+    }
+
+    long versoesAntesLiberar = arvore->nodosVersoes;
+    for (int s = 0; s < MAX_SNAPSHOTS_ATIVOS; s++) {
+        liberarSnapshot(ativos[s]);
+    }
+
+    printf("ORDEM: %-3d | Registros Inseridos: %-6d | Inserção sem snapshot: %.6f s | com snapshots: %.6f s (%.2fx) | Pico nós de versões: %ld (%.1f%% de %d, %.1f KB) | Snapshots consistentes: %d/%d | Nós após liberar: %ld (antes: %ld)\n",
+           ORDEM, lidos, tempoSemSnapshot, tempoComSnapshot, tempoSemSnapshot > 0 ? tempoComSnapshot / tempoSemSnapshot : 0.0,
+           picoVersoes, 100.0 * picoVersoes / nodosBase, nodosBase, picoVersoes * sizeof(nodo_t) / 1024.0,
+           consistentes, totalSnapshots, arvore->nodosVersoes, versoesAntesLiberar);
+
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+    free(registros);
+}
+
+// Tempo de parede em segundos (clock() soma o tempo de CPU de todas as threads)
+double tempoParede() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Sorteia um renavam dentro de [RENAVAM_MIN, RENAVAM_MIN + amplitude)
+unsigned long long sortearRenavam(unsigned long long amplitude) {
+    unsigned long long aleatorio = ((unsigned long long)rand() << 31) ^ (unsigned long long)rand();
+    return RENAVAM_MIN + aleatorio % amplitude;
+}
+
+// Executa inserções e depois buscas em lotes na árvore particionada e devolve a vazão (ops/s)
+double medirVazaoParticionada(ArvoreParticionada_t *particionada, Operacao_t *operacoes, unsigned long long amplitude) {
+    const char *modelos[] = {"Gol", "Onix", "Corolla", "Civic", "HB20"};
+    for (int i = 0; i < NUM_OPERACOES_PARTICIONADA; i++) {
+        unsigned long long chave = sortearRenavam(amplitude);
+        operacoes[i].tipo = OP_INSERIR;
+        operacoes[i].registro = criarRegistro(chave, modelos[i % 5], 1995 + i % 30, "Preto");
+        operacoes[i].chave = chave;
+    }
+
+    double inicio = tempoParede();
+    for (int i = 0; i < NUM_OPERACOES_PARTICIONADA; i += TAM_LOTE_PARTICIONADA) {
+        int tamanho = NUM_OPERACOES_PARTICIONADA - i < TAM_LOTE_PARTICIONADA ? NUM_OPERACOES_PARTICIONADA - i : TAM_LOTE_PARTICIONADA;
+        enviarLote(particionada, &operacoes[i], tamanho);
+    }
+    aguardarConclusao(particionada);
+
+    for (int i = 0; i < NUM_OPERACOES_PARTICIONADA; i++) {
+        operacoes[i].tipo = OP_BUSCAR;
+        operacoes[i].registro = NULL;
+    }
+    for (int i = 0; i < NUM_OPERACOES_PARTICIONADA; i += TAM_LOTE_PARTICIONADA) {
+        int tamanho = NUM_OPERACOES_PARTICIONADA - i < TAM_LOTE_PARTICIONADA ? NUM_OPERACOES_PARTICIONADA - i : TAM_LOTE_PARTICIONADA;
+        enviarLote(particionada, &operacoes[i], tamanho);
+    }
+    aguardarConclusao(particionada);
+    double fim = tempoParede();
+
+    return 2.0 * NUM_OPERACOES_PARTICIONADA / (fim - inicio);
+}
+
+// Mede a vazão da árvore particionada para diferentes quantidades de partições e
+// o efeito do rebalanceamento quando todas as chaves caem em um intervalo pequeno.
+void testarDesempenhoParticionada() {
+    int numParticoesTeste[] = {1, 2, 4, 8};
+    int numTestes = sizeof(numParticoesTeste) / sizeof(int);
+    unsigned long long amplitudeTotal = RENAVAM_MAX - RENAVAM_MIN + 1;
+
+    Operacao_t *operacoes = (Operacao_t *)malloc(NUM_OPERACOES_PARTICIONADA * sizeof(Operacao_t));
+    if (operacoes == NULL) {
+        perror("Erro ao alocar operações");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = 0; t < numTestes; t++) {
+        ArvoreParticionada_t *particionada = criarArvoreParticionada(numParticoesTeste[t], RENAVAM_MIN, RENAVAM_MAX);
+        double vazao = medirVazaoParticionada(particionada, operacoes, amplitudeTotal);
+        printf("ORDEM: %-3d | Partições: %-2d | Operações: %d (inserções + buscas, lotes de %d) | Vazão: %.0f ops/s\n",
+               ORDEM, numParticoesTeste[t], 2 * NUM_OPERACOES_PARTICIONADA, TAM_LOTE_PARTICIONADA, vazao);
+        destruirArvoreParticionada(particionada);
+    }
+
+    // Carga concentrada no primeiro oitavo do intervalo: só a partição 0 trabalha.
+    // A cada rodada a partição mais carregada na rodada anterior é dividida.
+    ArvoreParticionada_t *particionada = criarArvoreParticionada(4, RENAVAM_MIN, RENAVAM_MAX);
+    for (int rodada = 0; rodada < 4; rodada++) {
+        int particoesAntes = particionada->numParticoes;
+        double vazao = medirVazaoParticionada(particionada, operacoes, amplitudeTotal / 8);
+        int dividiu = rebalancearParticoes(particionada);
+        printf("ORDEM: %-3d | Carga concentrada, rodada %d | Partições: %-2d | Vazão: %.0f ops/s | Rebalanceamento: %s\n",
+               ORDEM, rodada, particoesAntes, vazao, dividiu ? "partição quente dividida" : "nenhuma divisão");
+    }
+    destruirArvoreParticionada(particionada);
+
+    free(operacoes);
+}
+
+// Compara a vazão de busca das especializações por tipo de chave (u32, u64,
+// composta e string). Cada árvore recebe NUM_CHAVES_GENERICAS chaves aleatórias,
+// que depois são todas buscadas.
+void testarDesempenhoTiposChave() {
+    const char *modelos[] = {"Gol", "Onix", "Corolla", "Civic", "HB20", "Fiesta", "Ka", "Sandero", "Compass", "Polo"};
+    int n = NUM_CHAVES_GENERICAS;
+    uint32_t *chavesU32 = (uint32_t *)malloc(n * sizeof(uint32_t));
+    unsigned long long *chavesU64 = (unsigned long long *)malloc(n * sizeof(unsigned long long));
+    chave_modelo_ano_t *chavesCompostas = (chave_modelo_ano_t *)malloc(n * sizeof(chave_modelo_ano_t));
+    char (*placas)[TAM_PLACA] = malloc(n * sizeof(*placas));
+    if (chavesU32 == NULL || chavesU64 == NULL || chavesCompostas == NULL || placas == NULL) {
+        perror("Erro ao alocar chaves de teste");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        chavesU32[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+        chavesU64[i] = sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1);
+        memset(&chavesCompostas[i], 0, sizeof(chave_modelo_ano_t));
+        strcpy(chavesCompostas[i].modelo, modelos[rand() % 10]);
+        chavesCompostas[i].ano = 1995 + rand() % 30;
+        chavesCompostas[i].renavam = chavesU64[i];
+        // Placa no padrão Mercosul: LLLNLNN
+        sprintf(placas[i], "%c%c%c%d%c%02d", 'A' + rand() % 26, 'A' + rand() % 26, 'A' + rand() % 26,
+                rand() % 10, 'A' + rand() % 26, rand() % 100);
+    }
+
+    ArvoreU32_t *arvoreU32 = criarArvoreU32();
+    ArvoreU64_t *arvoreU64 = criarArvoreU64();
+    ArvoreModeloAno_t *arvoreComposta = criarArvoreModeloAno();
+    ArvoreString_t *arvoreString = criarArvoreString();
+    for (int i = 0; i < n; i++) {
+        inserirArvoreU32(arvoreU32, chavesU32[i], NULL);
+        inserirArvoreU64(arvoreU64, chavesU64[i], NULL);
+        inserirArvoreModeloAno(arvoreComposta, chavesCompostas[i], NULL);
+        inserirArvoreString(arvoreString, chaveString(placas[i]), placas[i]);
+    }
+
+    long encontrados = 0;
+    double inicio = tempoParede();
+    for (int i = 0; i < n; i++) {
+        encontrados += (buscarArvoreU32(arvoreU32, chavesU32[i]) != NULL);
+    }
+    double tempoU32 = tempoParede() - inicio;
+    printf("Chave u32      | Ordem: %-3d | Nós: %-7d | Encontrados: %ld/%d | Vazão de busca: %.0f buscas/s\n",
+           ORDEM_POR_TAMANHO(uint32_t), arvoreU32->numNodos, encontrados, n, n / tempoU32);
+
+    encontrados = 0;
+    inicio = tempoParede();
+    for (int i = 0; i < n; i++) {
+        encontrados += (buscarArvoreU64(arvoreU64, chavesU64[i]) != NULL);
+    }
+    double tempoU64 = tempoParede() - inicio;
+    printf("Chave u64      | Ordem: %-3d | Nós: %-7d | Encontrados: %ld/%d | Vazão de busca: %.0f buscas/s\n",
+           ORDEM_POR_TAMANHO(unsigned long long), arvoreU64->numNodos, encontrados, n, n / tempoU64);
+
+    encontrados = 0;
+    inicio = tempoParede();
+    for (int i = 0; i < n; i++) {
+        encontrados += (buscarArvoreModeloAno(arvoreComposta, chavesCompostas[i]) != NULL);
+    }
+    double tempoComposta = tempoParede() - inicio;
+    printf("Chave composta | Ordem: %-3d | Nós: %-7d | Encontrados: %ld/%d | Vazão de busca: %.0f buscas/s\n",
+           ORDEM_POR_TAMANHO(chave_modelo_ano_t), arvoreComposta->numNodos, encontrados, n, n / tempoComposta);
+
+    encontrados = 0;
+    inicio = tempoParede();
+    for (int i = 0; i < n; i++) {
+        encontrados += (buscarArvoreString(arvoreString, chaveString(placas[i])) != NULL);
+    }
+    double tempoString = tempoParede() - inicio;
+    printf("Chave string   | Slots: %-3d | Nós: %-7d | Encontrados: %ld/%d | Vazão de busca: %.0f buscas/s\n",
+           MAX_CHAVES_STRING, arvoreString->numNodos, encontrados, n, n / tempoString);
+
+    destruirArvoreU32(arvoreU32);
+    destruirArvoreU64(arvoreU64);
+    destruirArvoreModeloAno(arvoreComposta);
+    destruirArvoreString(arvoreString);
+    free(chavesU32);
+    free(chavesU64);
+    free(chavesCompostas);
+    free(placas);
+}
+
+// Mede a memória ocupada pelos registros e o tempo de uma varredura completa pelo
+// encadeamento de folhas filtrando por modelo e ano. Compare compilando com
+// COMPACTO=0 e COMPACTO=1.
+void testarDesempenhoRegistros() {
+    const char *modelos[] = {"Gol", "Onix", "Corolla", "Civic", "HB20", "Fiesta", "Ka", "Sandero", "Compass", "Polo"};
+    const char *cores[] = {"Preto", "Branco", "Prata", "Vermelho", "Azul", "Cinza", "Verde"};
+
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    for (int i = 0; i < NUM_REGISTROS_VARREDURA; i++) {
+        registro_t *registro = criarRegistro(sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1), modelos[rand() % 10],
+                                             1995 + rand() % 30, cores[rand() % 7]);
+        inserir(arvore, registro);
+    }
+
+    nodo_t *primeira = arvore->raiz;
+    while (!primeira->folha) {
+        primeira = primeira->filhos[0];
+    }
+
+#if REGISTRO_COMPACTO
+    // No modo compacto o filtro compara códigos, sem decodificar o registro
+    int codigoGol = codigoModelo("Gol");
+    unsigned char anoMinimo = (unsigned char)(2010 - ANO_BASE);
+#endif
+
+    long total = 0, selecionados = 0;
+    double inicio = tempoParede();
+    for (int r = 0; r < REPETICOES_VARREDURA; r++) {
+        total = 0;
+        selecionados = 0;
+        for (nodo_t *folha = primeira; folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                registro_t *registro = folha->registros[i];
+#if REGISTRO_COMPACTO
+                if (registro->ano >= anoMinimo && registro->modelo == codigoGol) {
+#else
+                if (registro->ano >= 2010 && strcmp(registro->modelo, "Gol") == 0) {
+#endif
+                    selecionados++;
+                }
+            }
+            total += folha->numChaves;
+        }
+    }
+    double tempoVarredura = (tempoParede() - inicio) / REPETICOES_VARREDURA;
+
+    printf("ORDEM: %-3d | Registro %s: %zu bytes | Registros: %ld (%.1f MB) | Varredura (Gol, ano >= 2010): %.6f s (%ld selecionados, %.0f registros/s)\n",
+           ORDEM, REGISTRO_COMPACTO ? "compacto" : "completo", sizeof(registro_t), total,
+           total * sizeof(registro_t) / (1024.0 * 1024.0), tempoVarredura, selecionados, total / tempoVarredura);
+
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+}
+
+// Compara a inserção chave a chave com inserirLote() em uma árvore já carregada
+// com o arquivo de dados, para lotes de 100 a 1.000.000 de registros novos.
+void testarDesempenhoLote(const char *nomeArquivo, int numRegistrosBase) {
+    int tamanhosLote[] = {100, 1000, 10000, 100000, 1000000};
+    int numTamanhos = sizeof(tamanhosLote) / sizeof(int);
+
+    for (int t = 0; t < numTamanhos; t++) {
+        int tamanho = tamanhosLote[t];
+        unsigned long long *chaves = (unsigned long long *)malloc(tamanho * sizeof(unsigned long long));
+        registro_t **lote = (registro_t **)malloc(tamanho * sizeof(registro_t *));
+        if (chaves == NULL || lote == NULL) {
+            perror("Erro ao alocar lote");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < tamanho; i++) {
+            chaves[i] = sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1);
+        }
+
+        // Inserção chave a chave
+        BPlusTree_t *arvore = criarArvoreBPlus();
+        carregarRegistros(nomeArquivo, arvore, numRegistrosBase, NULL);
+        for (int i = 0; i < tamanho; i++) {
+            lote[i] = criarRegistro(chaves[i], "Gol", 2020, "Preto");
+        }
+        clock_t inicio = clock();
+        for (int i = 0; i < tamanho; i++) {
+            inserir(arvore, lote[i]);
+        }
+        clock_t fim = clock();
+        double tempoIndividual = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+        destruirArvoreBPlus(arvore->raiz);
+        free(arvore);
+
+        // Inserção em lote
+        arvore = criarArvoreBPlus();
+        carregarRegistros(nomeArquivo, arvore, numRegistrosBase, NULL);
+        for (int i = 0; i < tamanho; i++) {
+            lote[i] = criarRegistro(chaves[i], "Gol", 2020, "Preto");
+        }
+        inicio = clock();
+        inserirLote(arvore, lote, tamanho);
+        fim = clock();
+        double tempoLote = ((double)(fim - inicio)) / CLOCKS_PER_SEC;
+        int altura = alturaArvoreBPlus(arvore->raiz);
+        destruirArvoreBPlus(arvore->raiz);
+        free(arvore);
+
+        printf("ORDEM: %-3d | Lote: %-7d | Chave a chave: %.6f s (%.0f ins/s) | inserirLote: %.6f s (%.0f ins/s) | Ganho: %.2fx | Altura: %d\n",
+               ORDEM, tamanho, tempoIndividual, tamanho / tempoIndividual, tempoLote, tamanho / tempoLote,
+               tempoLote > 0 ? tempoIndividual / tempoLote : 0.0, altura);
+
+        free(chaves);
+        free(lote);
+    }
+}
+
+#if ESTATISTICAS_ORDEM
+// Compara contarIntervalo() e selecionar() com a varredura do encadeamento de folhas,
+// que era a única forma de responder contagens de intervalo e quantis.
+void testarDesempenhoEstatisticas(const char *nomeArquivo, int numRegistros) {
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    carregarRegistros(nomeArquivo, arvore, numRegistros, NULL);
+    long total = totalRegistros(arvore);
+
+    nodo_t *primeira = arvore->raiz;
+    while (!primeira->folha) {
+        primeira = primeira->filhos[0];
+    }
+
+    unsigned long long limites[2 * NUM_CONSULTAS_ESTATISTICAS];
+    for (int i = 0; i < 2 * NUM_CONSULTAS_ESTATISTICAS; i += 2) {
+        unsigned long long a = sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1);
+        unsigned long long b = sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1);
+        limites[i] = a < b ? a : b;
+        limites[i + 1] = a < b ? b : a;
+    }
+
+    // Contagem de intervalo pela varredura das folhas
+    long somaVarredura = 0;
+    double inicio = tempoParede();
+    for (int i = 0; i < 2 * NUM_CONSULTAS_ESTATISTICAS; i += 2) {
+        for (nodo_t *folha = primeira; folha != NULL; folha = folha->proximo) {
+            for (int j = 0; j < folha->numChaves; j++) {
+                somaVarredura += folha->chaves[j] >= limites[i] && folha->chaves[j] <= limites[i + 1];
+            }
+        }
+    }
+    double tempoVarredura = tempoParede() - inicio;
+
+    // Contagem de intervalo pelas contagens das subárvores
+    long somaContagem = 0;
+    inicio = tempoParede();
+    for (int i = 0; i < 2 * NUM_CONSULTAS_ESTATISTICAS; i += 2) {
+        somaContagem += contarIntervalo(arvore, limites[i], limites[i + 1]);
+    }
+    double tempoContagem = tempoParede() - inicio;
+
+    // Mediana: caminhar até a posição central versus selecionar()
+    registro_t *medianaVarredura = NULL;
+    long posicao = 0;
+    inicio = tempoParede();
+    for (nodo_t *folha = primeira; folha != NULL && medianaVarredura == NULL; folha = folha->proximo) {
+        if (posicao + folha->numChaves > total / 2) {
+            medianaVarredura = folha->registros[total / 2 - posicao];
+        }
+        posicao += folha->numChaves;
+    }
+    double tempoMedianaVarredura = tempoParede() - inicio;
+    inicio = tempoParede();
+    registro_t *mediana = selecionar(arvore, total / 2);
+    double tempoSelecionar = tempoParede() - inicio;
+
+    printf("ORDEM: %-3d | Registros: %-7ld | contarIntervalo: %.9f s/consulta (varredura: %.9f s, ganho %.0fx) | Mediana: selecionar %.9f s, varredura %.9f s | %s\n",
+           ORDEM, total, tempoContagem / NUM_CONSULTAS_ESTATISTICAS, tempoVarredura / NUM_CONSULTAS_ESTATISTICAS,
+           tempoContagem > 0 ? tempoVarredura / tempoContagem : 0.0, tempoSelecionar, tempoMedianaVarredura,
+           (somaContagem == somaVarredura && mediana == medianaVarredura) ? "resultados conferem" : "ERRO: resultados divergem");
+
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+}
+#endif
+
+// Buscas em que só uma fração das chaves existe ('taxa de acerto'), como nas
+// validações de renavam. Mede buscar() sem e com o filtro de Bloom e a taxa de
+// falsos positivos do filtro sobre as chaves ausentes.
+void testarDesempenhoBuscaNegativa(const char *nomeArquivo, int numRegistros) {
+    double taxasAcerto[] = {0.0, 0.1, 0.5, 0.9, 1.0};
+    int numTaxas = sizeof(taxasAcerto) / sizeof(double);
+
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    unsigned long long *chavesCarregadas = (unsigned long long *)malloc(numRegistros * sizeof(unsigned long long));
+    unsigned long long *consultas = (unsigned long long *)malloc(NUM_BUSCAS_NEGATIVAS * sizeof(unsigned long long));
+    if (chavesCarregadas == NULL || consultas == NULL) {
+        perror("Erro ao alocar chaves de busca");
+        exit(EXIT_FAILURE);
+    }
+    int carregados = carregarRegistros(nomeArquivo, arvore, numRegistros, chavesCarregadas);
+
+    for (int t = 0; t < numTaxas; t++) {
+        int ausentes = 0;
+        for (int i = 0; i < NUM_BUSCAS_NEGATIVAS; i++) {
+            if ((double)rand() / RAND_MAX < taxasAcerto[t]) {
+                consultas[i] = chavesCarregadas[rand() % carregados];
+            } else {
+                do {
+                    consultas[i] = sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1);
+                } while (buscar(arvore, consultas[i]) != NULL);
+                ausentes++;
+            }
+        }
+
+        desativarFiltroBloom(arvore);
+        int encontradosSemFiltro = 0;
+        double inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_NEGATIVAS; i++) {
+            encontradosSemFiltro += buscar(arvore, consultas[i]) != NULL;
+        }
+        double tempoSemFiltro = tempoParede() - inicio;
+
+        ativarFiltroBloom(arvore, BITS_POR_CHAVE_PADRAO);
+        int encontradosComFiltro = 0;
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_NEGATIVAS; i++) {
+            encontradosComFiltro += buscar(arvore, consultas[i]) != NULL;
+        }
+        double tempoComFiltro = tempoParede() - inicio;
+
+        // Chaves ausentes que o filtro deixou passar
+        int falsosPositivos = 0;
+        for (int i = 0; i < NUM_BUSCAS_NEGATIVAS; i++) {
+            if (buscar(arvore, consultas[i]) == NULL && consultarFiltroBloom(arvore->filtro, consultas[i])) {
+                falsosPositivos++;
+            }
+        }
+
+        printf("ORDEM: %-3d | Acerto: %3.0f%% | Sem filtro: %.6f s (%.0f buscas/s) | Com filtro: %.6f s (%.0f buscas/s) | Ganho: %.2fx | Falsos positivos: %.2f%% | Filtro: %.1f KB%s\n",
+               ORDEM, taxasAcerto[t] * 100, tempoSemFiltro, NUM_BUSCAS_NEGATIVAS / tempoSemFiltro,
+               tempoComFiltro, NUM_BUSCAS_NEGATIVAS / tempoComFiltro,
+               tempoComFiltro > 0 ? tempoSemFiltro / tempoComFiltro : 0.0,
+               ausentes > 0 ? 100.0 * falsosPositivos / ausentes : 0.0,
+               arvore->filtro->numBlocos * sizeof(BlocoBloom_t) / 1024.0,
+               encontradosSemFiltro == encontradosComFiltro ? "" : " | ERRO: resultados divergem");
+    }
+
+    desativarFiltroBloom(arvore);
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+    free(chavesCarregadas);
+    free(consultas);
+}
+
+// Cria cópias dos registros da árvore, na ordem das chaves (usadas pelas linhas de
+// base que reinserem registro a registro, como era feito antes de dividir/unir)
+registro_t **copiarRegistros(BPlusTree_t *arvore, int *quantidade) {
+    nodo_t *folha = arvore->raiz;
+    while (!folha->folha) {
+        folha = folha->filhos[0];
+    }
+    int total = 0;
+    for (nodo_t *atual = folha; atual != NULL; atual = atual->proximo) {
+        total += atual->numChaves;
+    }
+    registro_t **copias = (registro_t **)malloc((total > 0 ? total : 1) * sizeof(registro_t *));
+    if (copias == NULL) {
+        perror("Erro ao alocar cópias dos registros");
+        exit(EXIT_FAILURE);
+    }
+    int n = 0;
+    for (; folha != NULL; folha = folha->proximo) {
+        for (int i = 0; i < folha->numChaves; i++) {
+            registro_t *original = folha->registros[i];
+            copias[n++] = criarRegistro(original->chave, registroModelo(original), registroAno(original), registroCor(original));
+        }
+    }
+    *quantidade = n;
+    return copias;
+}
+
+// Compara dividirArvore() e unirArvores() com a reinserção registro a registro
+void testarDesempenhoDivisaoUniao() {
+    registro_t **lote = (registro_t **)malloc(NUM_REGISTROS_DIVISAO * sizeof(registro_t *));
+    if (lote == NULL) {
+        perror("Erro ao alocar lote");
+        exit(EXIT_FAILURE);
+    }
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    for (int i = 0; i < NUM_REGISTROS_DIVISAO; i++) {
+        lote[i] = criarRegistro(sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1), "Gol", 2020, "Preto");
+    }
+    inserirLote(arvore, lote, NUM_REGISTROS_DIVISAO);
+
+    int n;
+    registro_t **copias = copiarRegistros(arvore, &n);
+    unsigned long long mediana = copias[n / 2]->chave;
+
+    // Divisão na mediana
+    BPlusTree_t *esquerdaBase = criarArvoreBPlus();
+    BPlusTree_t *direitaBase = criarArvoreBPlus();
+    double inicio = tempoParede();
+    for (int i = 0; i < n; i++) {
+        inserir(i < n / 2 ? esquerdaBase : direitaBase, copias[i]);
+    }
+    double tempoReinsercaoDivisao = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    BPlusTree_t *direita = dividirArvore(arvore, mediana);
+    double tempoDivisao = tempoParede() - inicio;
+    int alturaEsquerda = alturaArvoreBPlus(arvore->raiz), alturaDireita = alturaArvoreBPlus(direita->raiz);
+    // A divisão não reconta os nós de cada parte; a recontagem fica para quando for pedida
+    inicio = tempoParede();
+    int nodosEsquerda = contarNodosArvore(arvore), nodosDireita = contarNodosArvore(direita);
+    double tempoRecontagem = tempoParede() - inicio;
+
+    // União de intervalos disjuntos
+    int numDireita;
+    registro_t **copiasDireita = copiarRegistros(direitaBase, &numDireita);
+    destruirArvoreBPlus(direitaBase->raiz);
+    free(direitaBase);
+    inicio = tempoParede();
+    for (int i = 0; i < numDireita; i++) {
+        inserir(esquerdaBase, copiasDireita[i]);
+    }
+    double tempoReinsercaoUniao = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    unirArvores(arvore, direita);
+    double tempoUniao = tempoParede() - inicio;
+
+    // União de intervalos sobrepostos (intercalação das folhas e reconstrução)
+    BPlusTree_t *outra = criarArvoreBPlus();
+    for (int i = 0; i < NUM_REGISTROS_DIVISAO / 2; i++) {
+        lote[i] = criarRegistro(sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1), "Onix", 2021, "Prata");
+    }
+    inserirLote(outra, lote, NUM_REGISTROS_DIVISAO / 2);
+    int numOutra;
+    registro_t **copiasOutra = copiarRegistros(outra, &numOutra);
+    inicio = tempoParede();
+    for (int i = 0; i < numOutra; i++) {
+        inserir(esquerdaBase, copiasOutra[i]);
+    }
+    double tempoReinsercaoIntercalada = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    unirArvores(arvore, outra);
+    double tempoIntercalada = tempoParede() - inicio;
+
+    printf("ORDEM: %-3d | Registros: %d | Divisão na mediana: dividirArvore %.6f s, reinserção %.6f s (%.0fx) | Alturas: %d e %d\n",
+           ORDEM, n, tempoDivisao, tempoReinsercaoDivisao, tempoDivisao > 0 ? tempoReinsercaoDivisao / tempoDivisao : 0.0,
+           alturaEsquerda, alturaDireita);
+    printf("ORDEM: %-3d | Nós após a divisão: %d e %d | Recontagem sob demanda: %.6f s\n",
+           ORDEM, nodosEsquerda, nodosDireita, tempoRecontagem);
+    printf("ORDEM: %-3d | União disjunta: unirArvores %.6f s, reinserção %.6f s (%.0fx) | Altura: %d\n",
+           ORDEM, tempoUniao, tempoReinsercaoUniao, tempoUniao > 0 ? tempoReinsercaoUniao / tempoUniao : 0.0,
+           alturaArvoreBPlus(arvore->raiz));
+    printf("ORDEM: %-3d | União sobreposta (+%d registros): unirArvores %.6f s, reinserção %.6f s (%.1fx) | Altura: %d\n",
+           ORDEM, numOutra, tempoIntercalada, tempoReinsercaoIntercalada,
+           tempoIntercalada > 0 ? tempoReinsercaoIntercalada / tempoIntercalada : 0.0, alturaArvoreBPlus(arvore->raiz));
+
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+    destruirArvoreBPlus(esquerdaBase->raiz);
+    free(esquerdaBase);
+    free(copias);
+    free(copiasDireita);
+    free(copiasOutra);
+    free(lote);
+}
+
+// Tempo médio de uma varredura completa pelo encadeamento de folhas
+double medirVarredura(BPlusTree_t *arvore) {
+    nodo_t *primeira = arvore->raiz;
+    while (!primeira->folha) {
+        primeira = primeira->filhos[0];
+    }
+    volatile unsigned long long soma = 0;
+    double inicio = tempoParede();
+    for (int r = 0; r < REPETICOES_VARREDURA; r++) {
+        for (nodo_t *folha = primeira; folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                soma += folha->chaves[i];
+            }
+        }
+    }
+    return (tempoParede() - inicio) / REPETICOES_VARREDURA;
+}
+
+void imprimirOcupacao(const char *rotulo, EstatisticasArvore_t *estatisticas, double tempoVarredura) {
+    printf("ORDEM: %-3d | %-8s | Nós: %-7ld | Folhas: %-7ld | Ocupação das folhas: %5.1f%% | Memória: %.1f MB | Varredura: %.6f s\n",
+           ORDEM, rotulo, estatisticas->numNodos, estatisticas->numFolhas, estatisticas->ocupacaoFolhas * 100,
+           estatisticas->memoria / (1024.0 * 1024.0), tempoVarredura);
+}
+
+// Carrega a árvore com inserções aleatórias (folhas ~70% cheias) e compacta as folhas
+// em passos curtos intercalados com novas inserções, como aconteceria em produção.
+void testarDesempenhoCompactacao() {
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    for (int i = 0; i < NUM_REGISTROS_COMPACTACAO; i++) {
+        inserir(arvore, criarRegistro(sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1), "Gol", 2020, "Preto"));
+    }
+    EstatisticasArvore_t antes, depois;
+    estatisticasArvore(arvore, &antes);
+    imprimirOcupacao("Antes", &antes, medirVarredura(arvore));
+
+    CompactadorFolhas_t compactador;
+    iniciarCompactacao(&compactador);
+    int passos = 0;
+    double tempoCompactacao = 0, maiorPasso = 0;
+    while (!compactador.concluida) {
+        double inicio = tempoParede();
+        compactarFolhasPasso(arvore, &compactador, GRUPOS_POR_PASSO, OCUPACAO_ALVO);
+        double duracao = tempoParede() - inicio;
+        tempoCompactacao += duracao;
+        if (duracao > maiorPasso) {
+            maiorPasso = duracao;
+        }
+        passos++;
+        for (int i = 0; i < INSERCOES_ENTRE_PASSOS; i++) {
+            inserir(arvore, criarRegistro(sortearRenavam(RENAVAM_MAX - RENAVAM_MIN + 1), "Gol", 2020, "Preto"));
+        }
+    }
+    estatisticasArvore(arvore, &depois);
+    imprimirOcupacao("Depois", &depois, medirVarredura(arvore));
+    printf("ORDEM: %-3d | Compactação (alvo %d%%): %d passos de %d grupos | Total: %.6f s | Maior passo: %.6f s | Folhas liberadas: %ld | Registros: %ld -> %ld\n",
+           ORDEM, OCUPACAO_ALVO, passos, GRUPOS_POR_PASSO, tempoCompactacao, maiorPasso,
+           compactador.folhasLiberadas, antes.numRegistros, depois.numRegistros);
+
+    destruirArvoreBPlus(arvore->raiz);
+    free(arvore);
+}
+
+// Executa as misturas do YCSB (A-F) e uma de buscas ausentes sobre árvores geradas
+// em memória, com chaves aleatórias e com chaves sequenciais. O gerador aceita até
+// 100 milhões de registros; os tamanhos abaixo cabem na execução padrão.
+void testarDesempenhoCarga() {
+    long tamanhos[] = {100000, 1000000};
+    Distribuicao disposicoes[] = {DIST_UNIFORME, DIST_SEQUENCIAL};
+    const char *nomesDisposicao[] = {"aleatórias", "sequenciais"};
+    MisturaOperacoes_t ausentes = {"Buscas ausentes (80%)", {20, 0, 0, 0, 80}, DIST_UNIFORME, 0};
+
+    for (int t = 0; t < (int)(sizeof(tamanhos) / sizeof(tamanhos[0])); t++) {
+        for (int d = 0; d < 2; d++) {
+            Carga_t *carga = criarCarga(SEMENTE_CARGA, disposicoes[d]);
+            BPlusTree_t *arvore = criarArvoreBPlus();
+            double inicio = tempoParede();
+            carregarCarga(carga, arvore, tamanhos[t]);
+            printf("ORDEM: %-3d | Registros: %-8ld | Chaves %-11s | Carga: %.6f s\n",
+                   ORDEM, tamanhos[t], nomesDisposicao[d], tempoParede() - inicio);
+
+            for (int m = 0; m <= 6; m++) {
+                const MisturaOperacoes_t *mistura = m < 6 ? misturaYCSB('A' + m) : &ausentes;
+                ResultadoCarga_t resultado;
+                inicio = tempoParede();
+                executarCarga(carga, arvore, mistura, NUM_OPERACOES_CARGA, &resultado);
+                double tempo = tempoParede() - inicio;
+                printf("    %-34s | %d operações: %.6f s (%.0f op/s) | Encontrados: %ld | Inserções: %ld | Varridos: %ld\n",
+                       mistura->nome, NUM_OPERACOES_CARGA, tempo, NUM_OPERACOES_CARGA / tempo,
+                       resultado.encontrados, resultado.operacoes[CARGA_INSERCAO], resultado.registrosVarridos);
+                if (resultado.ausentesEncontrados > 0) {
+                    fprintf(stderr, "Erro: %ld chaves ausentes encontradas.\n", resultado.ausentesEncontrados);
+                }
+            }
+
+            destruirArvoreBPlus(arvore->raiz);
+            free(arvore);
+            destruirCarga(carga);
+        }
+    }
+}
+
+// Versões recursivas da destruição e da contagem de nós, mantidas só para comparação
+void destruirRecursivo(nodo_t *nodo) {
+    if (!nodo->folha) {
+        for (int i = 0; i <= nodo->numChaves; i++) {
+            destruirRecursivo(nodo->filhos[i]);
+        }
+    }
+    destruirNodo(nodo);
+}
+
+// Percorre a árvore lendo cada nó entregue (a soma das chaves), como fazem a destruição e
+// a exportação; é onde o prefetch dos irmãos à frente pode esconder a latência
+double medirPercurso(BPlusTree_t *arvore, ModoPercurso modo, long *chaves) {
+    double inicio = tempoParede();
+    Percurso_t percurso;
+    nodo_t *nodo;
+    *chaves = 0;
+    iniciarPercurso(&percurso, arvore->raiz, modo);
+    while ((nodo = proximoNodo(&percurso, NULL)) != NULL) {
+        *chaves += nodo->numChaves;
+    }
+    encerrarPercurso(&percurso);
+    return tempoParede() - inicio;
+}
+
+long contarNodosRecursivo(nodo_t *nodo) {
+    long total = 1;
+    if (!nodo->folha) {
+        for (int i = 0; i <= nodo->numChaves; i++) {
+            total += contarNodosRecursivo(nodo->filhos[i]);
+        }
+    }
+    return total;
+}
+
+// Mede percurso completo, exportação DOT e destruição sobre árvores idênticas
+// (mesma semente), comparando a destruição e a contagem iterativas com as recursivas.
+void testarDesempenhoPercurso() {
+    Carga_t *carga = criarCarga(SEMENTE_CARGA, DIST_UNIFORME);
+    BPlusTree_t *arvore = criarArvoreBPlus();
+    carregarCarga(carga, arvore, NUM_REGISTROS_PERCURSO);
+    destruirCarga(carga);
+
+    EstatisticasArvore_t estatisticas;
+    double inicio = tempoParede();
+    estatisticasArvore(arvore, &estatisticas);
+    double tempoEstatisticas = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    long nodosIterativo = 0;
+    Percurso_t percurso;
+    iniciarPercurso(&percurso, arvore->raiz, PERCURSO_PROFUNDIDADE);
+    while (proximoNodo(&percurso, NULL) != NULL) {
+        nodosIterativo++;
+    }
+    encerrarPercurso(&percurso);
+    double tempoContagemIterativa = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    long nodosRecursivo = contarNodosRecursivo(arvore->raiz);
+    double tempoContagemRecursiva = tempoParede() - inicio;
+
+    long chavesPreOrdem, chavesPosOrdem, chavesLargura;
+    double tempoPreOrdem = medirPercurso(arvore, PERCURSO_PROFUNDIDADE, &chavesPreOrdem);
+    double tempoPosOrdem = medirPercurso(arvore, PERCURSO_POS_ORDEM, &chavesPosOrdem);
+    double tempoLargura = medirPercurso(arvore, PERCURSO_LARGURA, &chavesLargura);
+    if (chavesPreOrdem != chavesLargura || chavesPosOrdem != chavesLargura) {
+        fprintf(stderr, "Erro: os percursos somaram %ld, %ld e %ld chaves.\n", chavesPreOrdem, chavesPosOrdem, chavesLargura);
+    }
+
+    inicio = tempoParede();
+    gerarDot(arvore, "/dev/null"); //mede a formatação, sem o custo do disco
+    double tempoDot = tempoParede() - inicio;
+
+    inicio = tempoParede();
+    destruirArvoreBPlus(arvore->raiz);
+    double tempoDestruicao = tempoParede() - inicio;
+    free(arvore);
+
+    carga = criarCarga(SEMENTE_CARGA, DIST_UNIFORME);
+    arvore = criarArvoreBPlus();
+    carregarCarga(carga, arvore, NUM_REGISTROS_PERCURSO);
+    destruirCarga(carga);
+    inicio = tempoParede();
+    destruirRecursivo(arvore->raiz);
+    double tempoDestruicaoRecursiva = tempoParede() - inicio;
+    free(arvore);
+
+    printf("ORDEM: %-3d | Registros: %d | Nós: %ld (iterativo: %ld, recursivo: %ld) | Altura: %d\n",
+           ORDEM, NUM_REGISTROS_PERCURSO, estatisticas.numNodos, nodosIterativo, nodosRecursivo, estatisticas.altura);
+    printf("    Contagem: %.6f s | Recursiva: %.6f s | Estatísticas: %.6f s\n", tempoContagemIterativa, tempoContagemRecursiva, tempoEstatisticas);
+    printf("    Percurso lendo cada nó (prefetch de %d irmãos à frente): pré-ordem %.6f s | pós-ordem %.6f s | largura %.6f s\n",
+           DISTANCIA_PREFETCH, tempoPreOrdem, tempoPosOrdem, tempoLargura);
+    printf("    Destruição: %.6f s | Recursiva: %.6f s\n", tempoDestruicao, tempoDestruicaoRecursiva);
+    printf("    Exportação DOT: %.6f s\n", tempoDot);
+}
+
+// Visitante de percorrerIntervalo que só conta os registros
+int contarVisitados(registro_t *registro, void *contexto) {
+    (void)registro;
+    (*(long *)contexto)++;
+    return 1;
+}
+
+// Compara as buscas pontuais descendo pelos nós internos e pela ART, sobre as
+// mesmas chaves existentes, confere que as varreduras de intervalo dão o mesmo
+// resultado nos dois modos e mede as inserções com a ART sendo mantida.
+void testarDesempenhoHibrido() {
+    long tamanhos[] = {10000, 100000, 1000000};
+    const char *nomesTipo[NUM_TIPOS_ART] = {"4", "16", "48", "256"};
+    unsigned long long *chaves = (unsigned long long *)malloc(NUM_BUSCAS_HIBRIDO * sizeof(unsigned long long));
+    long *contagens = (long *)malloc(NUM_VARREDURAS_HIBRIDO * sizeof(long));
+    if (chaves == NULL || contagens == NULL) {
+        perror("Erro ao alocar chaves do teste híbrido");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = 0; t < (int)(sizeof(tamanhos) / sizeof(tamanhos[0])); t++) {
+        Carga_t *carga = criarCarga(SEMENTE_CARGA, DIST_UNIFORME);
+        BPlusTree_t *arvore = criarArvoreBPlus();
+        carregarCarga(carga, arvore, tamanhos[t]);
+        for (int i = 0; i < NUM_BUSCAS_HIBRIDO; i++) {
+            chaves[i] = escolherChave(carga, DIST_UNIFORME);
+        }
+        unsigned long long largura = (RENAVAM_MAX - RENAVAM_MIN) / (2 * tamanhos[t]) * REGISTROS_POR_VARREDURA;
+
+        long encontrados = 0;
+        double inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HIBRIDO; i++) {
+            encontrados += buscar(arvore, chaves[i]) != NULL;
+        }
+        double tempoArvore = tempoParede() - inicio;
+        for (int v = 0; v < NUM_VARREDURAS_HIBRIDO; v++) {
+            contagens[v] = 0;
+            percorrerIntervalo(arvore, chaves[v], chaves[v] + largura, contarVisitados, &contagens[v]);
+        }
+
+        inicio = tempoParede();
+        ativarIndiceHibrido(arvore);
+        double tempoConstrucao = tempoParede() - inicio;
+
+        long encontradosHibrido = 0;
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HIBRIDO; i++) {
+            encontradosHibrido += buscar(arvore, chaves[i]) != NULL;
+        }
+        double tempoHibrido = tempoParede() - inicio;
+        int divergencias = 0;
+        for (int v = 0; v < NUM_VARREDURAS_HIBRIDO; v++) {
+            long contagem = 0;
+            percorrerIntervalo(arvore, chaves[v], chaves[v] + largura, contarVisitados, &contagem);
+            divergencias += contagem != contagens[v];
+        }
+        if (encontrados != NUM_BUSCAS_HIBRIDO || encontradosHibrido != encontrados || divergencias > 0) {
+            fprintf(stderr, "Erro: índice híbrido divergiu (encontrados %ld/%ld, varreduras diferentes: %d).\n",
+                    encontradosHibrido, encontrados, divergencias);
+        }
+
+        // Registros novos com a ART ativa: cada split de folha vira uma entrada a mais
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_INSERCOES_HIBRIDO; i++) {
+            inserir(arvore, gerarRegistro(carga));
+        }
+        double tempoInsercao = tempoParede() - inicio;
+        long novosEncontrados = 0;
+        for (long i = tamanhos[t]; i < tamanhos[t] + NUM_INSERCOES_HIBRIDO; i++) {
+            novosEncontrados += buscar(arvore, chaveDoIndice(carga, i)) != NULL;
+        }
+        if (novosEncontrados != NUM_INSERCOES_HIBRIDO) {
+            fprintf(stderr, "Erro: %ld registros inseridos não encontrados pelo índice híbrido.\n",
+                    NUM_INSERCOES_HIBRIDO - novosEncontrados);
+        }
+
+        IndiceHibrido_t *hibrido = arvore->hibrido;
+        printf("ORDEM: %-3d | Registros: %-8ld | Altura: %d | Construção da ART: %.6f s\n",
+               ORDEM, tamanhos[t], alturaArvoreBPlus(arvore->raiz), tempoConstrucao);
+        printf("    %d buscas | Árvore: %.6f s | Híbrido: %.6f s (%.2fx, com %.2f MB de ART além da árvore)\n",
+               NUM_BUSCAS_HIBRIDO, tempoArvore, tempoHibrido, tempoArvore / tempoHibrido,
+               memoriaIndiceHibrido(hibrido) / (1024.0 * 1024.0));
+        printf("    %d varreduras de ~%d registros conferidas | %d inserções com a ART ativa: %.6f s\n",
+               NUM_VARREDURAS_HIBRIDO, REGISTROS_POR_VARREDURA, NUM_INSERCOES_HIBRIDO, tempoInsercao);
+        printf("    ART: %ld folhas indexadas | Nós:", hibrido->numEntradas);
+        for (int k = 0; k < NUM_TIPOS_ART; k++) {
+            printf(" %s=%ld", nomesTipo[k], hibrido->numNodos[k]);
+        }
+        printf("\n");
+
+        desativarIndiceHibrido(arvore);
+        destruirArvoreBPlus(arvore->raiz);
+        free(arvore);
+        destruirCarga(carga);
+    }
+    free(chaves);
+    free(contagens);
+}
+
+// Visitante de percorrerIntervalo que soma o registro ao agregado
+int agregarVisitado(registro_t *registro, void *contexto) {
+    agregarRegistro((AgregadoVarredura_t *)contexto, registro);
+    return 1;
+}
+
+// Confere totais e grupos de uma varredura paralela contra a sequencial
+int agregadosIguais(const AgregadoVarredura_t *a, const AgregadoVarredura_t *b) {
+    if (a->numRegistros != b->numRegistros || a->numGrupos != b->numGrupos ||
+        (a->numRegistros > 0 && (a->menorChave != b->menorChave || a->maiorChave != b->maiorChave ||
+                                 a->anoMin != b->anoMin || a->anoMax != b->anoMax))) {
+        return 0;
+    }
+    for (int i = 0; i < a->capacidadeGrupos; i++) {
+        const GrupoVarredura_t *grupo = &a->grupos[i];
+        if (grupo->quantidade == 0) {
+            continue;
+        }
+        const GrupoVarredura_t *outro = buscarGrupo(b, grupo->modelo, grupo->cor);
+        if (outro == NULL || outro->quantidade != grupo->quantidade ||
+            outro->anoMin != grupo->anoMin || outro->anoMax != grupo->anoMax) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Auditoria de todo o cadastro (e de 10% dele) com 1 a 8 threads, comparada com a
+// varredura sequencial pelo encadeamento das folhas; os resultados têm que ser iguais.
+void testarDesempenhoVarreduraParalela() {
+    int threads[] = {1, 2, 4, 8};
+    Distribuicao disposicoes[] = {DIST_UNIFORME, DIST_SEQUENCIAL};
+    const char *nomesDisposicao[] = {"aleatórias", "sequenciais"};
+
+    for (int d = 0; d < 2; d++) {
+        Carga_t *carga = criarCarga(SEMENTE_CARGA, disposicoes[d]);
+        BPlusTree_t *arvore = criarArvoreBPlus();
+        carregarCarga(carga, arvore, NUM_REGISTROS_VARREDURA_PARALELA);
+        unsigned long long menor = chaveDoIndice(carga, 0), maior = menor;
+        for (long i = 1; i < NUM_REGISTROS_VARREDURA_PARALELA; i++) {
+            unsigned long long chave = chaveDoIndice(carga, i);
+            menor = chave < menor ? chave : menor;
+            maior = chave > maior ? chave : maior;
+        }
+        destruirCarga(carga);
+        unsigned long long intervalos[2][2] = {{0, ~0ULL}, {menor + (maior - menor) / 2, menor + (maior - menor) / 2 + (maior - menor) / 10}};
+        const char *nomesIntervalo[] = {"todo o cadastro", "10% das chaves"};
+
+        for (int v = 0; v < 2; v++) {
+            AgregadoVarredura_t sequencial;
+            iniciarAgregado(&sequencial);
+            double inicio = tempoParede();
+            percorrerIntervalo(arvore, intervalos[v][0], intervalos[v][1], agregarVisitado, &sequencial);
+            double tempoSequencial = tempoParede() - inicio;
+            printf("ORDEM: %-3d | Chaves %-11s | %-15s | %ld registros, %d grupos (modelo, cor) | Sequencial: %.6f s\n",
+                   ORDEM, nomesDisposicao[d], nomesIntervalo[v], sequencial.numRegistros, sequencial.numGrupos, tempoSequencial);
+
+            for (int t = 0; t < (int)(sizeof(threads) / sizeof(threads[0])); t++) {
+                PoolVarredura_t *pool = criarPoolVarredura(threads[t]);
+                double tempo = 0;
+                int corretos = 1;
+                for (int r = 0; r < REPETICOES_VARREDURA_PARALELA; r++) {
+                    AgregadoVarredura_t paralelo;
+                    inicio = tempoParede();
+                    varrerParalelo(pool, arvore, intervalos[v][0], intervalos[v][1], &paralelo);
+                    tempo += tempoParede() - inicio;
+                    corretos &= agregadosIguais(&sequencial, &paralelo);
+                    liberarAgregado(&paralelo);
+                }
+                tempo /= REPETICOES_VARREDURA_PARALELA;
+                printf("    %d thread(s): %.6f s (%.1f M registros/s, %.2fx) | Pedaços: %d | Roubados: %ld%s\n",
+                       threads[t], tempo, sequencial.numRegistros / tempo / 1e6, tempoSequencial / tempo,
+                       pool->numTarefas, pool->ultimasRoubadas, corretos ? "" : " | ERRO: resultado diferente");
+                destruirPoolVarredura(pool);
+            }
+            liberarAgregado(&sequencial);
+        }
+
+        destruirArvoreBPlus(arvore->raiz);
+        free(arvore);
+    }
+}
+
+// Buscas pontuais pela árvore e pela tabela de espalhamento sobre as mesmas chaves
+// (existentes e ausentes), com a memória extra da tabela. A latência de inserção é
+// medida numa tabela que cresce do zero até todas as chaves: com o redimensionamento
+// incremental o pior caso fica longe do custo de reconstruir a tabela inteira.
+void testarDesempenhoIndiceHash() {
+    long tamanhos[] = {100000, 1000000};
+    unsigned long long *chaves = (unsigned long long *)malloc(NUM_BUSCAS_HASH * sizeof(unsigned long long));
+    unsigned long long *ausentes = (unsigned long long *)malloc(NUM_BUSCAS_HASH * sizeof(unsigned long long));
+    if (chaves == NULL || ausentes == NULL) {
+        perror("Erro ao alocar chaves do teste de espalhamento");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = 0; t < (int)(sizeof(tamanhos) / sizeof(tamanhos[0])); t++) {
+        Carga_t *carga = criarCarga(SEMENTE_CARGA, DIST_UNIFORME);
+        BPlusTree_t *arvore = criarArvoreBPlus();
+        carregarCarga(carga, arvore, tamanhos[t]);
+        for (int i = 0; i < NUM_BUSCAS_HASH; i++) {
+            chaves[i] = escolherChave(carga, DIST_UNIFORME);
+            ausentes[i] = chaveAusente(carga);
+        }
+
+        long encontrados = 0, encontradosHash = 0, falsos = 0;
+        double inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HASH; i++) {
+            encontrados += buscar(arvore, chaves[i]) != NULL;
+        }
+        double tempoArvore = tempoParede() - inicio;
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HASH; i++) {
+            falsos += buscar(arvore, ausentes[i]) != NULL;
+        }
+        double tempoArvoreAusentes = tempoParede() - inicio;
+
+        inicio = tempoParede();
+        ativarIndiceHash(arvore);
+        double tempoConstrucao = tempoParede() - inicio;
+
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HASH; i++) {
+            encontradosHash += buscar(arvore, chaves[i]) != NULL;
+        }
+        double tempoHash = tempoParede() - inicio;
+        inicio = tempoParede();
+        for (int i = 0; i < NUM_BUSCAS_HASH; i++) {
+            falsos += buscar(arvore, ausentes[i]) != NULL;
+        }
+        double tempoHashAusentes = tempoParede() - inicio;
+        if (encontrados != NUM_BUSCAS_HASH || encontradosHash != encontrados || falsos > 0) {
+            fprintf(stderr, "Erro: índice de espalhamento divergiu (encontrados %ld/%ld, ausentes achados: %ld).\n",
+                    encontradosHash, encontrados, falsos);
+        }
+
+        // Tabela nova, crescendo uma chave por vez a partir da capacidade mínima
+        IndiceHash_t *crescente = criarIndiceHash(0);
+        double piorInsercao = 0;
+        inicio = tempoParede();
+        nodo_t *folha = arvore->raiz;
+        while (!folha->folha) {
+            folha = folha->filhos[0];
+        }
+        for (; folha != NULL; folha = folha->proximo) {
+            for (int i = 0; i < folha->numChaves; i++) {
+                double antes = tempoParede();
+                inserirIndiceHash(crescente, folha->registros[i]);
+                double duracao = tempoParede() - antes;
+                piorInsercao = duracao > piorInsercao ? duracao : piorInsercao;
+            }
+        }
+        double tempoCrescente = tempoParede() - inicio;
+
+        size_t memoriaArvore = (size_t)contarNodosArvore(arvore) * sizeof(nodo_t);
+        size_t memoriaHash = memoriaIndiceHash(arvore->hash);
+        printf("ORDEM: %-3d | Registros: %-8ld | Altura: %d | Construção da tabela: %.6f s\n",
+               ORDEM, tamanhos[t], alturaArvoreBPlus(arvore->raiz), tempoConstrucao);
+        printf("    %d buscas existentes | Árvore: %.6f s | Tabela: %.6f s (%.2fx)\n",
+               NUM_BUSCAS_HASH, tempoArvore, tempoHash, tempoArvore / tempoHash);
+        printf("    %d buscas ausentes   | Árvore: %.6f s | Tabela: %.6f s (%.2fx)\n",
+               NUM_BUSCAS_HASH, tempoArvoreAusentes, tempoHashAusentes, tempoArvoreAusentes / tempoHashAusentes);
+        printf("    Memória | Nós da árvore: %.2f MB | Tabela: %.2f MB (+%.0f%%, %.1f bytes/registro)\n",
+               memoriaArvore / (1024.0 * 1024.0), memoriaHash / (1024.0 * 1024.0),
+               100.0 * memoriaHash / memoriaArvore, (double)memoriaHash / tamanhos[t]);
+        printf("    Tabela crescendo do zero: %.6f s, %ld redimensionamentos | Pior inserção: %.1f us (média %.3f us)\n",
+               tempoCrescente, crescente->numRedimensionamentos, piorInsercao * 1e6, tempoCrescente / tamanhos[t] * 1e6);
+
+        destruirIndiceHash(crescente);
+        desativarIndiceHash(arvore);
+        destruirArvoreBPlus(arvore->raiz);
+        free(arvore);
+        destruirCarga(carga);
+    }
+    free(chaves);
+    free(ausentes);
+}
+
 // Testa o desempenho da inserção de registros.
 void testarDesempenhoInsercao(BPlusTree_t *arvore, const char *nomeArquivo, int numRegistros) {
 
@@ -119,8 +1319,13 @@ int main() {
 
         // Teste de Desempenho de Busca
         BPlusTree_t *arvoreBusca = criarArvoreBPlus();
-        carregarRegistros(nomeArquivoDados, arvoreBusca, numRegistros, NULL);
+        unsigned long long *chavesCarregadas = (unsigned long long *)malloc(numRegistros * sizeof(unsigned long long));
+        int carregados = carregarRegistros(nomeArquivoDados, arvoreBusca, numRegistros, chavesCarregadas);
         testarDesempenhoBusca(arvoreBusca, numRegistros);
+        testarDesempenhoCongelada(arvoreBusca, chavesCarregadas, carregados);
+        free(chavesCarregadas);
+
+        testarDesempenhoSnapshot(nomeArquivoDados, numRegistros);
 
         int altura = alturaArvoreBPlus(arvoreBusca->raiz);
         printf("Altura da Árvore B+ com REGISTRO %d = %d\n", numRegistros, altura);
@@ -131,6 +1336,62 @@ int main() {
         printf("-----------------------------------------------------------------------------------------------------------\n");
     }
 
+    printf("--- Inserção em Lote sobre árvore carregada com '%s' ---\n", nomeArquivoDados);
+    testarDesempenhoLote(nomeArquivoDados, tamanhosTeste[numTamanhos - 1]);
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Árvore Particionada (uma thread por partição) ---\n");
+    testarDesempenhoParticionada();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Tipos de Chave (árvores especializadas em tempo de compilação) ---\n");
+    testarDesempenhoTiposChave();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Formato dos Registros ---\n");
+    testarDesempenhoRegistros();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Buscas Negativas com Filtro de Bloom ---\n");
+    testarDesempenhoBuscaNegativa(nomeArquivoDados, tamanhosTeste[numTamanhos - 1]);
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Divisão e União de Árvores ---\n");
+    testarDesempenhoDivisaoUniao();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Compactação Incremental das Folhas ---\n");
+    testarDesempenhoCompactacao();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Cargas Sintéticas (misturas do YCSB, semente %d) ---\n", SEMENTE_CARGA);
+    testarDesempenhoCarga();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Percurso Iterativo (destruição, estatísticas e exportação) ---\n");
+    testarDesempenhoPercurso();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Índice Híbrido (ART sobre as folhas) ---\n");
+    testarDesempenhoHibrido();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Varredura Paralela com Agregação (contagem, mín/máx, modelo x cor) ---\n");
+    testarDesempenhoVarreduraParalela();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Índice de Espalhamento (buscas pontuais em O(1)) ---\n");
+    testarDesempenhoIndiceHash();
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
+    printf("--- Estatísticas de Ordem (rank, selecionar, contarIntervalo) ---\n");
+#if ESTATISTICAS_ORDEM
+    testarDesempenhoEstatisticas(nomeArquivoDados, tamanhosTeste[numTamanhos - 1]);
+#else
+    printf("Desativadas nesta compilação (use 'make ESTATISTICAS=1').\n");
+#endif
+    printf("-----------------------------------------------------------------------------------------------------------\n");
+
     // Seção de Visualização
 
     printf("--- Visualização (ORDEM=%d, %d registros) ---\n", ORDEM, REGISTROS);
@@ -172,6 +1433,9 @@ int main() {
 
     destruirArvoreBPlus(arvoreExemplo->raiz);
     free(arvoreExemplo);
+#if REGISTRO_COMPACTO
+    liberarPoolRegistros();
+#endif
 
 
     return 0;
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <sched.h>
+#include <time.h>
+#include "particionada.h"
+
+#define GIROS_ANTES_DE_CEDER 64
+#define CESSOES_ANTES_DE_DORMIR 256
+#define LOTE_PUBLICACAO 64 //operações atendidas antes de publicar o contador de concluídas
+
+static Operacao_t operacaoEncerrar = {OP_ENCERRAR, 0, NULL};
+
+// ====================================================================================
+// Fila SPSC
+// ====================================================================================
+
+static int _enfileirarSPSC(FilaSPSC_t *fila, Operacao_t *operacao) {
+    size_t cauda = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    size_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_acquire);
+    if (cauda - cabeca == TAM_FILA_PARTICAO) {
+        return 0; // Fila cheia
+    }
+    fila->itens[cauda & (TAM_FILA_PARTICAO - 1)] = operacao;
+    atomic_store_explicit(&fila->cauda, cauda + 1, memory_order_release);
+    return 1;
+}
+
+static Operacao_t *_desenfileirarSPSC(FilaSPSC_t *fila) {
+    size_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_relaxed);
+    size_t cauda = atomic_load_explicit(&fila->cauda, memory_order_acquire);
+    if (cabeca == cauda) {
+        return NULL; // Fila vazia
+    }
+    Operacao_t *operacao = fila->itens[cabeca & (TAM_FILA_PARTICAO - 1)];
+    atomic_store_explicit(&fila->cabeca, cabeca + 1, memory_order_release);
+    return operacao;
+}
+
+// Espera ativa com recuo: gira, depois cede a CPU e por fim dorme por instantes
+static void _esperar(int *tentativas) {
+    (*tentativas)++;
+    if (*tentativas < GIROS_ANTES_DE_CEDER) {
+        return;
+    }
+    if (*tentativas < GIROS_ANTES_DE_CEDER + CESSOES_ANTES_DE_DORMIR) {
+        sched_yield();
+        return;
+    }
+    struct timespec pausa = {0, 50000};
+    nanosleep(&pausa, NULL);
+}
+
+// ====================================================================================
+// Thread de cada partição
+// ====================================================================================
+
+static void *_trabalhadorParticao(void *arg) {
+    Particao_t *particao = (Particao_t *)arg;
+    int tentativas = 0;
+    long pendentes = 0; // atendidas e ainda não publicadas
+
+    for (;;) {
+        Operacao_t *operacao = _desenfileirarSPSC(&particao->fila);
+        if (operacao == NULL) {
+            if (pendentes > 0) {
+                atomic_fetch_add_explicit(&particao->concluidas, pendentes, memory_order_release);
+                pendentes = 0;
+            }
+            _esperar(&tentativas);
+            continue;
+        }
+        tentativas = 0;
+
+        switch (operacao->tipo) {
+            case OP_INSERIR:
+                inserir(particao->arvore, operacao->registro);
+                break;
+            case OP_BUSCAR:
+                operacao->registro = buscar(particao->arvore, operacao->chave);
+                break;
+            case OP_ENCERRAR:
+                atomic_fetch_add_explicit(&particao->concluidas, pendentes + 1, memory_order_release);
+                return NULL;
+        }
+        atomic_fetch_add_explicit(&particao->operacoes, 1, memory_order_relaxed);
+
+        if (++pendentes == LOTE_PUBLICACAO) {
+            atomic_fetch_add_explicit(&particao->concluidas, pendentes, memory_order_release);
+            pendentes = 0;
+        }
+    }
+}
+
+static Particao_t *_criarParticao(BPlusTree_t *arvore) {
+    size_t tamanho = (sizeof(Particao_t) + 63) / 64 * 64;
+    Particao_t *particao = (Particao_t *)aligned_alloc(64, tamanho);
+    if (particao == NULL) {
+        perror("Erro ao alocar partição");
+        exit(EXIT_FAILURE);
+    }
+    particao->arvore = arvore;
+    atomic_init(&particao->fila.cabeca, 0);
+    atomic_init(&particao->fila.cauda, 0);
+    atomic_init(&particao->concluidas, 0);
+    atomic_init(&particao->operacoes, 0);
+    particao->enviadas = 0;
+    if (pthread_create(&particao->thread, NULL, _trabalhadorParticao, particao) != 0) {
+        perror("Erro ao criar thread da partição");
+        exit(EXIT_FAILURE);
+    }
+    return particao;
+}
+
+// Envia uma operação, esperando enquanto a fila da partição estiver cheia
+static void _enviar(Particao_t *particao, Operacao_t *operacao) {
+    int tentativas = 0;
+    while (!_enfileirarSPSC(&particao->fila, operacao)) {
+        _esperar(&tentativas);
+    }
+    particao->enviadas++;
+}
+
+static void _aguardarParticao(Particao_t *particao) {
+    int tentativas = 0;
+    while (atomic_load_explicit(&particao->concluidas, memory_order_acquire) < particao->enviadas) {
+        _esperar(&tentativas);
+    }
+}
+
+// ====================================================================================
+// API da árvore particionada
+// ====================================================================================
+
+ArvoreParticionada_t *criarArvoreParticionada(int numParticoes, unsigned long long chaveMin, unsigned long long chaveMax) {
+    if (numParticoes < 1 || numParticoes > MAX_PARTICOES || chaveMax < chaveMin) {
+        fprintf(stderr, "Erro: configuração de partições inválida.\n");
+        return NULL;
+    }
+    ArvoreParticionada_t *particionada = (ArvoreParticionada_t *)malloc(sizeof(ArvoreParticionada_t));
+    if (particionada == NULL) {
+        perror("Erro ao alocar árvore particionada");
+        exit(EXIT_FAILURE);
+    }
+    particionada->numParticoes = numParticoes;
+    unsigned long long largura = (chaveMax - chaveMin) / numParticoes + 1;
+    for (int i = 0; i < numParticoes; i++) {
+        particionada->limites[i] = (i == 0) ? 0 : chaveMin + largura * i;
+        particionada->particoes[i] = _criarParticao(criarArvoreBPlus());
+    }
+    return particionada;
+}
+
+void destruirArvoreParticionada(ArvoreParticionada_t *particionada) {
+    if (particionada == NULL) {
+        return;
+    }
+    for (int i = 0; i < particionada->numParticoes; i++) {
+        Particao_t *particao = particionada->particoes[i];
+        _enviar(particao, &operacaoEncerrar);
+        pthread_join(particao->thread, NULL);
+        destruirArvoreBPlus(particao->arvore->raiz);
+        free(particao->arvore);
+        free(particao);
+    }
+    free(particionada);
+}
+
+// Busca binária pela última partição cujo limite inferior é <= chave
+static int _obterParticao(ArvoreParticionada_t *particionada, unsigned long long chave) {
+    int inicio = 0, fim = particionada->numParticoes - 1;
+    while (inicio < fim) {
+        int meio = (inicio + fim + 1) / 2;
+        if (particionada->limites[meio] <= chave) {
+            inicio = meio;
+        } else {
+            fim = meio - 1;
+        }
+    }
+    return inicio;
+}
+
+void enviarLote(ArvoreParticionada_t *particionada, Operacao_t *operacoes, int numOperacoes) {
+    for (int i = 0; i < numOperacoes; i++) {
+        if (operacoes[i].tipo == OP_INSERIR) {
+            operacoes[i].chave = operacoes[i].registro->chave;
+        }
+        _enviar(particionada->particoes[_obterParticao(particionada, operacoes[i].chave)], &operacoes[i]);
+    }
+}
+
+void aguardarConclusao(ArvoreParticionada_t *particionada) {
+    for (int i = 0; i < particionada->numParticoes; i++) {
+        _aguardarParticao(particionada->particoes[i]);
+    }
+}
+
+void executarLote(ArvoreParticionada_t *particionada, Operacao_t *operacoes, int numOperacoes) {
+    enviarLote(particionada, operacoes, numOperacoes);
+    aguardarConclusao(particionada);
+}
+
+void inserirParticionada(ArvoreParticionada_t *particionada, registro_t *registro) {
+    Operacao_t operacao = {OP_INSERIR, registro->chave, registro};
+    executarLote(particionada, &operacao, 1);
+}
+
+registro_t *buscarParticionada(ArvoreParticionada_t *particionada, unsigned long long chave) {
+    Operacao_t operacao = {OP_BUSCAR, chave, NULL};
+    executarLote(particionada, &operacao, 1);
+    return operacao.registro;
+}
+
+// Divide a partição mais carregada pela sua chave mediana. Deve ser chamada pelo
+// produtor entre lotes; as threads estão ociosas e só voltam a tocar nas árvores
+// depois de receber novas operações.
+int rebalancearParticoes(ArvoreParticionada_t *particionada) {
+    if (particionada->numParticoes >= MAX_PARTICOES) {
+        return 0;
+    }
+    aguardarConclusao(particionada);
+
+    long total = 0, maior = -1;
+    int quente = 0;
+    for (int i = 0; i < particionada->numParticoes; i++) {
+        long carga = atomic_load_explicit(&particionada->particoes[i]->operacoes, memory_order_relaxed);
+        total += carga;
+        if (carga > maior) {
+            maior = carga;
+            quente = i;
+        }
+    }
+    for (int i = 0; i < particionada->numParticoes; i++) {
+        atomic_store_explicit(&particionada->particoes[i]->operacoes, 0, memory_order_relaxed);
+    }
+    double media = (double)total / particionada->numParticoes;
+    if (total == 0 || (particionada->numParticoes > 1 && maior < FATOR_PARTICAO_QUENTE * media)) {
+        return 0;
+    }
+
+    // Acha a chave mediana da partição quente
+    BPlusTree_t *esquerda = particionada->particoes[quente]->arvore;
+    unsigned long long mediana = 0;
+#if ESTATISTICAS_ORDEM
+    long numRegistros = totalRegistros(esquerda);
+    if (numRegistros < 2) {
+        return 0;
+    }
+    mediana = selecionar(esquerda, numRegistros / 2)->chave;
+#else
+    nodo_t *primeira = esquerda->raiz;
+    while (!primeira->folha) {
+        primeira = primeira->filhos[0];
+    }
+    long numRegistros = 0;
+    for (nodo_t *folha = primeira; folha != NULL; folha = folha->proximo) {
+        numRegistros += folha->numChaves;
+    }
+    if (numRegistros < 2) {
+        return 0;
+    }
+    long posicao = 0;
+    for (nodo_t *folha = primeira; folha != NULL; folha = folha->proximo) {
+        if (posicao + folha->numChaves > numRegistros / 2) {
+            mediana = folha->chaves[numRegistros / 2 - posicao];
+            break;
+        }
+        posicao += folha->numChaves;
+    }
+#endif
+
+    // Corta a árvore na mediana pelo caminho raiz-folha, sem reinserir registros
+    BPlusTree_t *direita = dividirArvore(esquerda, mediana);
+    for (int i = particionada->numParticoes; i > quente + 1; i--) {
+        particionada->particoes[i] = particionada->particoes[i - 1];
+        particionada->limites[i] = particionada->limites[i - 1];
+    }
+    particionada->particoes[quente + 1] = _criarParticao(direita);
+    particionada->limites[quente + 1] = mediana;
+    particionada->numParticoes++;
+    return 1;
+}
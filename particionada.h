@@ -0,0 +1,59 @@
+#ifndef PARTICIONADA_H
+#define PARTICIONADA_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "BPlusTree.h"
+
+#define MAX_PARTICOES 64
+#define TAM_FILA_PARTICAO 1024 //capacidade da fila de cada partição (potência de 2)
+#define FATOR_PARTICAO_QUENTE 2.0 //carga relativa à média a partir da qual a partição é dividida
+
+//tipos de operação aceitos pelas partições
+typedef enum {
+    OP_INSERIR,
+    OP_BUSCAR,
+    OP_ENCERRAR
+} TipoOperacao;
+
+//operação enviada a uma partição; o resultado da busca volta em 'registro'
+typedef struct {
+    TipoOperacao tipo; //tipo da operação
+    unsigned long long chave; //chave buscada (para inserção é a chave do registro)
+    registro_t *registro; //registro a inserir ou registro encontrado (NULL se ausente)
+} Operacao_t;
+
+//fila sem travas com um único produtor e um único consumidor
+typedef struct {
+    Operacao_t *itens[TAM_FILA_PARTICAO];
+    _Alignas(64) atomic_size_t cabeca; //próxima posição a consumir (escrita pelo consumidor)
+    _Alignas(64) atomic_size_t cauda; //próxima posição livre (escrita pelo produtor)
+} FilaSPSC_t;
+
+//partição: uma árvore independente atendida por uma thread exclusiva
+typedef struct {
+    BPlusTree_t *arvore; //árvore da partição (acessada só pela thread da partição)
+    FilaSPSC_t fila; //operações pendentes
+    pthread_t thread; //thread trabalhadora
+    _Alignas(64) atomic_long concluidas; //operações concluídas (publicadas pela thread)
+    atomic_long operacoes; //operações atendidas desde o último rebalanceamento
+    long enviadas; //operações enviadas (controlado pelo produtor)
+} Particao_t;
+
+//árvore particionada por intervalos de chave; usada por um único produtor
+typedef struct {
+    Particao_t *particoes[MAX_PARTICOES]; //partições em ordem de chave
+    unsigned long long limites[MAX_PARTICOES]; //menor chave atendida por cada partição
+    int numParticoes; //quantidade de partições ativas
+} ArvoreParticionada_t;
+
+ArvoreParticionada_t *criarArvoreParticionada(int numParticoes, unsigned long long chaveMin, unsigned long long chaveMax); //divide [chaveMin, chaveMax] em intervalos iguais
+void destruirArvoreParticionada(ArvoreParticionada_t *particionada); //encerra as threads e destrói as árvores
+void enviarLote(ArvoreParticionada_t *particionada, Operacao_t *operacoes, int numOperacoes); //distribui as operações sem esperar
+void aguardarConclusao(ArvoreParticionada_t *particionada); //espera todas as operações enviadas
+void executarLote(ArvoreParticionada_t *particionada, Operacao_t *operacoes, int numOperacoes); //envia e aguarda
+void inserirParticionada(ArvoreParticionada_t *particionada, registro_t *registro); //inserção individual (síncrona)
+registro_t *buscarParticionada(ArvoreParticionada_t *particionada, unsigned long long chave); //busca individual (síncrona)
+int rebalancearParticoes(ArvoreParticionada_t *particionada); //divide a partição mais carregada; retorna 1 se dividiu
+
+#endif // PARTICIONADA_H
@@ -0,0 +1,71 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+#include <stdint.h>
+#include "BPlusTree.h"
+
+// Protocolo binário do servidor da árvore B+ (socket de domínio Unix).
+// Cliente e servidor rodam na mesma máquina, então os campos usam a ordem de bytes nativa.
+// Cada mensagem é um cabeçalho seguido de 'tamanho' bytes de corpo. O cliente pode enviar
+// várias requisições sem esperar as respostas (pipelining); o servidor responde na ordem
+// de chegada e devolve o 'id' de cada requisição.
+
+#define CAMINHO_SOCKET_PADRAO "/tmp/arvore_bplus.sock"
+#define MAX_CORPO_PROTOCOLO 65536 //corpo máximo de uma mensagem (conexões que excedem são fechadas)
+#define MAX_VARREDURA_PROTOCOLO 1024 //registros devolvidos por uma varredura, no máximo
+
+typedef enum {
+    OP_GET = 1, //corpo: uint64_t chave -> RegistroProtocolo_t
+    OP_PUT, //corpo: RegistroProtocolo_t -> vazio (insere ou substitui)
+    OP_RANGE, //corpo: IntervaloProtocolo_t -> uint32_t quantidade, uint32_t reservado, RegistroProtocolo_t[quantidade]
+    OP_STATS //corpo vazio -> EstatisticasProtocolo_t
+} OperacaoProtocolo;
+
+typedef enum {
+    STATUS_OK = 0,
+    STATUS_NAO_ENCONTRADO, //GET de chave inexistente
+    STATUS_SUBSTITUIDO, //PUT de chave existente: os dados do registro foram trocados
+    STATUS_INVALIDA //operação desconhecida, corpo com tamanho errado ou registro que não cabe no modo compacto
+} StatusProtocolo;
+
+typedef struct {
+    uint32_t tamanho; //bytes do corpo
+    uint32_t id; //escolhido pelo cliente, devolvido na resposta
+    uint8_t operacao; //OperacaoProtocolo
+    uint8_t reservado[3];
+} CabecalhoRequisicao_t;
+
+typedef struct {
+    uint32_t tamanho; //bytes do corpo
+    uint32_t id; //id da requisição respondida
+    uint8_t status; //StatusProtocolo
+    uint8_t reservado[3];
+} CabecalhoResposta_t;
+
+typedef struct {
+    uint64_t chave;
+    int32_t ano;
+    char modelo[TAM_MODELO];
+    char cor[TAM_COR];
+    char reservado[4]; //mantém o tamanho múltiplo de 8
+} RegistroProtocolo_t;
+
+typedef struct {
+    uint64_t inicio;
+    uint64_t fim; //inclusivo
+    uint32_t limite; //máximo de registros (limitado a MAX_VARREDURA_PROTOCOLO)
+    uint32_t reservado;
+} IntervaloProtocolo_t;
+
+typedef struct {
+    uint64_t numRegistros;
+    uint64_t numNodos;
+    uint64_t numFolhas;
+    uint64_t altura;
+    uint64_t memoria; //bytes ocupados pelos nós
+    uint64_t requisicoes; //requisições atendidas desde o início do servidor
+    uint64_t conexoes; //conexões abertas no momento
+    double ocupacaoFolhas;
+} EstatisticasProtocolo_t;
+
+#endif // PROTOCOLO_H
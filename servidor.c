@@ -0,0 +1,415 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "BPlusTree.h"
+#include "carga.h"
+#include "protocolo.h"
+
+#define MAX_EVENTOS 64
+#define TAM_LEITURA 65536 //bytes lidos por vez de uma conexão
+#define LIMITE_SAIDA (4 * 1024 * 1024) //acima disso a conexão para de ser lida até o cliente consumir as respostas
+#define SEMENTE_PADRAO 42
+
+// Estado de um cliente conectado
+typedef struct {
+    int fd;
+    char *entrada; //bytes recebidos ainda não processados
+    size_t tamEntrada, capEntrada;
+    char *saida; //respostas acumuladas, enviadas de uma vez
+    size_t tamSaida, capSaida, enviados;
+    unsigned int eventos; //eventos registrados no epoll
+} Conexao_t;
+
+typedef struct {
+    BPlusTree_t *arvore;
+    int epoll;
+    unsigned long long requisicoes;
+    unsigned long long conexoes;
+} Servidor_t;
+
+static volatile sig_atomic_t encerrar = 0;
+
+static void _sinalEncerrar(int sinal) {
+    (void)sinal;
+    encerrar = 1;
+}
+
+// ====================================================================================
+// Buffers
+// ====================================================================================
+
+static void _reservar(char **buffer, size_t *capacidade, size_t necessario) {
+    if (necessario <= *capacidade) {
+        return;
+    }
+    size_t nova = *capacidade > 0 ? *capacidade : TAM_LEITURA;
+    while (nova < necessario) {
+        nova *= 2;
+    }
+    char *novo = (char *)realloc(*buffer, nova);
+    if (novo == NULL) {
+        perror("Erro ao alocar buffer da conexão");
+        exit(EXIT_FAILURE);
+    }
+    *buffer = novo;
+    *capacidade = nova;
+}
+
+// Reserva espaço para uma resposta com 'tamanho' bytes de corpo e devolve o início do corpo
+static char *_iniciarResposta(Conexao_t *conexao, uint32_t id, uint8_t status, uint32_t tamanho) {
+    _reservar(&conexao->saida, &conexao->capSaida, conexao->tamSaida + sizeof(CabecalhoResposta_t) + tamanho);
+    CabecalhoResposta_t cabecalho = {tamanho, id, status, {0}};
+    memcpy(conexao->saida + conexao->tamSaida, &cabecalho, sizeof(cabecalho));
+    char *corpo = conexao->saida + conexao->tamSaida + sizeof(cabecalho);
+    conexao->tamSaida += sizeof(cabecalho) + tamanho;
+    return corpo;
+}
+
+// ====================================================================================
+// Operações
+// ====================================================================================
+
+static void _paraProtocolo(const registro_t *registro, RegistroProtocolo_t *destino) {
+    memset(destino, 0, sizeof(*destino));
+    destino->chave = registro->chave;
+    destino->ano = registroAno(registro);
+    strncpy(destino->modelo, registroModelo(registro), TAM_MODELO - 1);
+    strncpy(destino->cor, registroCor(registro), TAM_COR - 1);
+}
+
+static void _get(Servidor_t *servidor, Conexao_t *conexao, uint32_t id, const char *corpo) {
+    uint64_t chave;
+    memcpy(&chave, corpo, sizeof(chave));
+    registro_t *registro = buscar(servidor->arvore, chave);
+    if (registro == NULL) {
+        _iniciarResposta(conexao, id, STATUS_NAO_ENCONTRADO, 0);
+        return;
+    }
+    RegistroProtocolo_t resposta;
+    _paraProtocolo(registro, &resposta);
+    memcpy(_iniciarResposta(conexao, id, STATUS_OK, sizeof(resposta)), &resposta, sizeof(resposta));
+}
+
+static void _put(Servidor_t *servidor, Conexao_t *conexao, uint32_t id, const char *corpo) {
+    RegistroProtocolo_t recebido;
+    memcpy(&recebido, corpo, sizeof(recebido));
+    recebido.modelo[TAM_MODELO - 1] = '\0';
+    recebido.cor[TAM_COR - 1] = '\0';
+    registro_t *existente = buscar(servidor->arvore, recebido.chave);
+    if (existente != NULL) {
+        // A árvore guarda ponteiros para os registros: basta trocar o conteúdo
+        int cabe = atualizarRegistro(existente, recebido.modelo, recebido.ano, recebido.cor);
+        _iniciarResposta(conexao, id, cabe ? STATUS_SUBSTITUIDO : STATUS_INVALIDA, 0);
+        return;
+    }
+    // No modo compacto o ano e os nomes precisam caber no registro; sem isso só este PUT falha
+    registro_t *novo = criarRegistro(recebido.chave, recebido.modelo, recebido.ano, recebido.cor);
+    if (novo == NULL) {
+        _iniciarResposta(conexao, id, STATUS_INVALIDA, 0);
+        return;
+    }
+    inserir(servidor->arvore, novo);
+    _iniciarResposta(conexao, id, STATUS_OK, 0);
+}
+
+typedef struct {
+    Conexao_t *conexao;
+    size_t inicioCorpo; //deslocamento do corpo em 'saida' (o buffer pode ser realocado)
+    uint32_t quantidade, limite;
+} Varredura;
+
+static int _visitarVarredura(registro_t *registro, void *contexto) {
+    Varredura *varredura = (Varredura *)contexto;
+    Conexao_t *conexao = varredura->conexao;
+    RegistroProtocolo_t resposta;
+    _paraProtocolo(registro, &resposta);
+    _reservar(&conexao->saida, &conexao->capSaida, conexao->tamSaida + sizeof(resposta));
+    memcpy(conexao->saida + conexao->tamSaida, &resposta, sizeof(resposta));
+    conexao->tamSaida += sizeof(resposta);
+    return ++varredura->quantidade < varredura->limite;
+}
+
+static void _range(Servidor_t *servidor, Conexao_t *conexao, uint32_t id, const char *corpo) {
+    IntervaloProtocolo_t intervalo;
+    memcpy(&intervalo, corpo, sizeof(intervalo));
+    size_t inicioCabecalho = conexao->tamSaida;
+    _iniciarResposta(conexao, id, STATUS_OK, 2 * sizeof(uint32_t));
+
+    Varredura varredura = {conexao, inicioCabecalho + sizeof(CabecalhoResposta_t), 0,
+                           intervalo.limite < MAX_VARREDURA_PROTOCOLO ? intervalo.limite : MAX_VARREDURA_PROTOCOLO};
+    if (varredura.limite > 0 && intervalo.inicio <= intervalo.fim) {
+        percorrerIntervalo(servidor->arvore, intervalo.inicio, intervalo.fim, _visitarVarredura, &varredura);
+    }
+    // Completa o cabeçalho e a quantidade depois de conhecer o número de registros
+    uint32_t tamanho = 2 * sizeof(uint32_t) + varredura.quantidade * sizeof(RegistroProtocolo_t);
+    memcpy(conexao->saida + inicioCabecalho, &tamanho, sizeof(tamanho));
+    memcpy(conexao->saida + varredura.inicioCorpo, &varredura.quantidade, sizeof(uint32_t));
+}
+
+static void _stats(Servidor_t *servidor, Conexao_t *conexao, uint32_t id) {
+    EstatisticasArvore_t estatisticas;
+    estatisticasArvore(servidor->arvore, &estatisticas);
+    EstatisticasProtocolo_t resposta = {
+        (uint64_t)estatisticas.numRegistros, (uint64_t)estatisticas.numNodos, (uint64_t)estatisticas.numFolhas,
+        (uint64_t)estatisticas.altura, (uint64_t)estatisticas.memoria,
+        servidor->requisicoes, servidor->conexoes, estatisticas.ocupacaoFolhas};
+    memcpy(_iniciarResposta(conexao, id, STATUS_OK, sizeof(resposta)), &resposta, sizeof(resposta));
+}
+
+// Atende as requisições completas do buffer de entrada, até a saída pendente passar de
+// LIMITE_SAIDA. As respostas vão para o buffer de saída, então um lote de requisições
+// vira uma única escrita no socket. Devolve quantas foram atendidas, ou -1 se o
+// cliente violou o protocolo.
+static int _processar(Servidor_t *servidor, Conexao_t *conexao) {
+    size_t posicao = 0;
+    int atendidas = 0;
+    while (conexao->tamSaida - conexao->enviados < LIMITE_SAIDA &&
+           conexao->tamEntrada - posicao >= sizeof(CabecalhoRequisicao_t)) {
+        CabecalhoRequisicao_t cabecalho;
+        memcpy(&cabecalho, conexao->entrada + posicao, sizeof(cabecalho));
+        if (cabecalho.tamanho > MAX_CORPO_PROTOCOLO) {
+            return -1;
+        }
+        if (conexao->tamEntrada - posicao < sizeof(cabecalho) + cabecalho.tamanho) {
+            break; //requisição incompleta: espera o restante
+        }
+        const char *corpo = conexao->entrada + posicao + sizeof(cabecalho);
+        if (cabecalho.operacao == OP_GET && cabecalho.tamanho == sizeof(uint64_t)) {
+            _get(servidor, conexao, cabecalho.id, corpo);
+        } else if (cabecalho.operacao == OP_PUT && cabecalho.tamanho == sizeof(RegistroProtocolo_t)) {
+            _put(servidor, conexao, cabecalho.id, corpo);
+        } else if (cabecalho.operacao == OP_RANGE && cabecalho.tamanho == sizeof(IntervaloProtocolo_t)) {
+            _range(servidor, conexao, cabecalho.id, corpo);
+        } else if (cabecalho.operacao == OP_STATS && cabecalho.tamanho == 0) {
+            _stats(servidor, conexao, cabecalho.id);
+        } else {
+            _iniciarResposta(conexao, cabecalho.id, STATUS_INVALIDA, 0);
+        }
+        servidor->requisicoes++;
+        atendidas++;
+        posicao += sizeof(cabecalho) + cabecalho.tamanho;
+    }
+    memmove(conexao->entrada, conexao->entrada + posicao, conexao->tamEntrada - posicao);
+    conexao->tamEntrada -= posicao;
+    return atendidas;
+}
+
+// ====================================================================================
+// Conexões e Laço de Eventos
+// ====================================================================================
+
+static void _fecharConexao(Servidor_t *servidor, Conexao_t *conexao) {
+    epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, conexao->fd, NULL);
+    close(conexao->fd);
+    free(conexao->entrada);
+    free(conexao->saida);
+    free(conexao);
+    servidor->conexoes--;
+}
+
+static void _aceitar(Servidor_t *servidor, int escuta) {
+    for (;;) {
+        int fd = accept4(escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("Erro ao aceitar conexão");
+            }
+            return;
+        }
+        Conexao_t *conexao = (Conexao_t *)calloc(1, sizeof(Conexao_t));
+        if (conexao == NULL) {
+            perror("Erro ao alocar conexão");
+            exit(EXIT_FAILURE);
+        }
+        conexao->fd = fd;
+        conexao->eventos = EPOLLIN;
+        struct epoll_event evento = {.events = conexao->eventos, .data.ptr = conexao};
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) < 0) {
+            perror("Erro ao registrar conexão no epoll");
+            close(fd);
+            free(conexao);
+            continue;
+        }
+        servidor->conexoes++;
+    }
+}
+
+// Envia o que couber das respostas pendentes. Devolve -1 se a conexão caiu.
+static int _escrever(Conexao_t *conexao) {
+    while (conexao->enviados < conexao->tamSaida) {
+        ssize_t n = send(conexao->fd, conexao->saida + conexao->enviados,
+                         conexao->tamSaida - conexao->enviados, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        conexao->enviados += (size_t)n;
+    }
+    conexao->tamSaida = conexao->enviados = 0;
+    return 0;
+}
+
+// Lê o que estiver disponível. Devolve -1 se o cliente fechou a conexão ou houve erro.
+static int _ler(Conexao_t *conexao) {
+    _reservar(&conexao->entrada, &conexao->capEntrada, conexao->tamEntrada + TAM_LEITURA);
+    ssize_t n = read(conexao->fd, conexao->entrada + conexao->tamEntrada, conexao->capEntrada - conexao->tamEntrada);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+    if (n == 0) {
+        return -1;
+    }
+    conexao->tamEntrada += (size_t)n;
+    return 0;
+}
+
+// Com muitas respostas pendentes a conexão deixa de ser lida (contrapressão);
+// com respostas pendentes ela espera o socket aceitar mais dados.
+static void _atualizarEventos(Servidor_t *servidor, Conexao_t *conexao) {
+    size_t pendente = conexao->tamSaida - conexao->enviados;
+    unsigned int eventos = (pendente < LIMITE_SAIDA ? EPOLLIN : 0) | (pendente > 0 ? EPOLLOUT : 0);
+    if (eventos != conexao->eventos) {
+        struct epoll_event evento = {.events = eventos, .data.ptr = conexao};
+        epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao->fd, &evento);
+        conexao->eventos = eventos;
+    }
+}
+
+static void _atenderConexao(Servidor_t *servidor, Conexao_t *conexao, unsigned int eventos) {
+    if ((eventos & (EPOLLIN | EPOLLHUP | EPOLLERR)) && _ler(conexao) < 0) {
+        _fecharConexao(servidor, conexao);
+        return;
+    }
+    // Alterna processamento e escrita enquanto houver progresso. Só para quando a saída
+    // passa do limite (EPOLLOUT traz a conexão de volta) ou quando não sobrou requisição
+    // completa na entrada: o cliente pode não mandar mais nada, e nenhum evento voltaria
+    // a acordar a conexão com requisições retidas pela contrapressão.
+    for (;;) {
+        int retida = conexao->tamSaida - conexao->enviados >= LIMITE_SAIDA;
+        int atendidas = _processar(servidor, conexao);
+        if (atendidas < 0 || _escrever(conexao) < 0) {
+            _fecharConexao(servidor, conexao);
+            return;
+        }
+        if (conexao->tamSaida - conexao->enviados >= LIMITE_SAIDA || (atendidas == 0 && !retida)) {
+            break;
+        }
+    }
+    _atualizarEventos(servidor, conexao);
+}
+
+static int _criarSocketEscuta(const char *caminho) {
+    struct sockaddr_un endereco;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        fprintf(stderr, "Erro: caminho do socket longo demais: %s\n", caminho);
+        exit(EXIT_FAILURE);
+    }
+    int escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (escuta < 0) {
+        perror("Erro ao criar socket");
+        exit(EXIT_FAILURE);
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    unlink(caminho);
+    if (bind(escuta, (struct sockaddr *)&endereco, sizeof(endereco)) < 0 || listen(escuta, SOMAXCONN) < 0) {
+        perror("Erro ao abrir o socket de escuta");
+        exit(EXIT_FAILURE);
+    }
+    return escuta;
+}
+
+static void _uso(const char *programa) {
+    fprintf(stderr, "Uso: %s [-s caminho do socket] [-n registros iniciais] [-r semente] [-b bits por chave do filtro de Bloom] [-t (tabela de espalhamento para GET)]\n", programa);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    const char *caminho = CAMINHO_SOCKET_PADRAO;
+    long registrosIniciais = 0;
+    unsigned long long semente = SEMENTE_PADRAO;
+    int bitsFiltro = 0;
+    int tabelaHash = 0;
+    int opcao;
+    while ((opcao = getopt(argc, argv, "s:n:r:b:t")) != -1) {
+        switch (opcao) {
+            case 's': caminho = optarg; break;
+            case 'n': registrosIniciais = atol(optarg); break;
+            case 'r': semente = strtoull(optarg, NULL, 10); break;
+            case 'b': bitsFiltro = atoi(optarg); break;
+            case 't': tabelaHash = 1; break;
+            default: _uso(argv[0]);
+        }
+    }
+
+    Servidor_t servidor = {criarArvoreBPlus(), -1, 0, 0};
+    if (registrosIniciais > 0) {
+        // Mesma semente no cliente de carga = mesmas chaves, então ele sabe o que existe
+        Carga_t *carga = criarCarga(semente, DIST_UNIFORME);
+        carregarCarga(carga, servidor.arvore, registrosIniciais);
+        destruirCarga(carga);
+    }
+    if (bitsFiltro > 0) {
+        ativarFiltroBloom(servidor.arvore, bitsFiltro);
+    }
+    if (tabelaHash) {
+        ativarIndiceHash(servidor.arvore);
+    }
+
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = _sinalEncerrar; //sem SA_RESTART: o epoll_wait é interrompido
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+
+    int escuta = _criarSocketEscuta(caminho);
+    servidor.epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (servidor.epoll < 0) {
+        perror("Erro ao criar epoll");
+        exit(EXIT_FAILURE);
+    }
+    struct epoll_event evento = {.events = EPOLLIN, .data.ptr = NULL};
+    epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, escuta, &evento);
+    printf("Servidor da árvore B+ (ORDEM=%d) em %s com %ld registros.\n", ORDEM, caminho, registrosIniciais);
+    fflush(stdout);
+
+    struct epoll_event eventos[MAX_EVENTOS];
+    while (!encerrar) {
+        int n = epoll_wait(servidor.epoll, eventos, MAX_EVENTOS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Erro no epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.ptr == NULL) {
+                _aceitar(&servidor, escuta);
+            } else {
+                _atenderConexao(&servidor, (Conexao_t *)eventos[i].data.ptr, eventos[i].events);
+            }
+        }
+    }
+
+    printf("Encerrando: %llu requisições atendidas.\n", servidor.requisicoes);
+    close(escuta);
+    close(servidor.epoll);
+    unlink(caminho);
+    desativarFiltroBloom(servidor.arvore);
+    desativarIndiceHash(servidor.arvore);
+    destruirArvoreBPlus(servidor.arvore->raiz);
+    free(servidor.arvore);
+    return 0;
+}
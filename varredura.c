@@ -0,0 +1,400 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "varredura.h"
+
+#define CAPACIDADE_INICIAL_GRUPOS 64
+
+// ====================================================================================
+// Agregação (contagem, mínimo/máximo e agrupamento por modelo e cor)
+// ====================================================================================
+
+// FNV-1a sobre o modelo e a cor
+static unsigned int _hashGrupo(const char *modelo, const char *cor) {
+    unsigned int h = 2166136261u;
+    for (const char *c = modelo; *c != '\0'; c++) {
+        h = (h ^ (unsigned char)*c) * 16777619u;
+    }
+    h = (h ^ 0xFFu) * 16777619u; // separa "ab"+"c" de "a"+"bc"
+    for (const char *c = cor; *c != '\0'; c++) {
+        h = (h ^ (unsigned char)*c) * 16777619u;
+    }
+    return h;
+}
+
+// Posição do par na tabela: a do próprio grupo ou a livre onde ele entraria
+static GrupoVarredura_t *_posicaoGrupo(GrupoVarredura_t *grupos, int capacidade, const char *modelo, const char *cor) {
+    unsigned int i = _hashGrupo(modelo, cor) & (capacidade - 1);
+    while (grupos[i].quantidade != 0 &&
+           (strncmp(grupos[i].modelo, modelo, TAM_MODELO - 1) != 0 || strncmp(grupos[i].cor, cor, TAM_COR - 1) != 0)) {
+        i = (i + 1) & (capacidade - 1);
+    }
+    return &grupos[i];
+}
+
+static void _redimensionarGrupos(AgregadoVarredura_t *agregado, int capacidade) {
+    GrupoVarredura_t *grupos = (GrupoVarredura_t *)calloc(capacidade, sizeof(GrupoVarredura_t));
+    if (grupos == NULL) {
+        perror("Erro ao alocar grupos da varredura");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < agregado->capacidadeGrupos; i++) {
+        GrupoVarredura_t *grupo = &agregado->grupos[i];
+        if (grupo->quantidade != 0) {
+            *_posicaoGrupo(grupos, capacidade, grupo->modelo, grupo->cor) = *grupo;
+        }
+    }
+    free(agregado->grupos);
+    agregado->grupos = grupos;
+    agregado->capacidadeGrupos = capacidade;
+}
+
+// Grupo do par, criado vazio (anos ainda não definidos) se ainda não existir
+static GrupoVarredura_t *_obterGrupo(AgregadoVarredura_t *agregado, const char *modelo, const char *cor, int *novo) {
+    // Ocupação máxima de 50%: as sondagens continuam curtas
+    if (2 * (agregado->numGrupos + 1) > agregado->capacidadeGrupos) {
+        _redimensionarGrupos(agregado, agregado->capacidadeGrupos ? 2 * agregado->capacidadeGrupos : CAPACIDADE_INICIAL_GRUPOS);
+    }
+    GrupoVarredura_t *grupo = _posicaoGrupo(agregado->grupos, agregado->capacidadeGrupos, modelo, cor);
+    *novo = grupo->quantidade == 0;
+    if (*novo) {
+        strncpy(grupo->modelo, modelo, TAM_MODELO - 1);
+        grupo->modelo[TAM_MODELO - 1] = '\0';
+        strncpy(grupo->cor, cor, TAM_COR - 1);
+        grupo->cor[TAM_COR - 1] = '\0';
+        agregado->numGrupos++;
+    }
+    return grupo;
+}
+
+void iniciarAgregado(AgregadoVarredura_t *agregado) {
+    agregado->numRegistros = 0;
+    agregado->menorChave = 0;
+    agregado->maiorChave = 0;
+    agregado->anoMin = 0;
+    agregado->anoMax = 0;
+    agregado->grupos = NULL;
+    agregado->capacidadeGrupos = 0;
+    agregado->numGrupos = 0;
+}
+
+void liberarAgregado(AgregadoVarredura_t *agregado) {
+    free(agregado->grupos);
+    iniciarAgregado(agregado);
+}
+
+// Zera os totais mantendo a tabela alocada (reaproveitada entre varreduras)
+static void _limparAgregado(AgregadoVarredura_t *agregado) {
+    if (agregado->grupos != NULL) {
+        memset(agregado->grupos, 0, agregado->capacidadeGrupos * sizeof(GrupoVarredura_t));
+    }
+    agregado->numRegistros = 0;
+    agregado->numGrupos = 0;
+}
+
+void agregarRegistro(AgregadoVarredura_t *agregado, const registro_t *registro) {
+    int ano = registroAno(registro);
+    if (agregado->numRegistros == 0) {
+        agregado->menorChave = agregado->maiorChave = registro->chave;
+        agregado->anoMin = agregado->anoMax = ano;
+    } else {
+        if (registro->chave < agregado->menorChave) agregado->menorChave = registro->chave;
+        if (registro->chave > agregado->maiorChave) agregado->maiorChave = registro->chave;
+        if (ano < agregado->anoMin) agregado->anoMin = ano;
+        if (ano > agregado->anoMax) agregado->anoMax = ano;
+    }
+    agregado->numRegistros++;
+
+    int novo;
+    GrupoVarredura_t *grupo = _obterGrupo(agregado, registroModelo(registro), registroCor(registro), &novo);
+    if (novo) {
+        grupo->anoMin = grupo->anoMax = ano;
+    } else {
+        if (ano < grupo->anoMin) grupo->anoMin = ano;
+        if (ano > grupo->anoMax) grupo->anoMax = ano;
+    }
+    grupo->quantidade++;
+}
+
+void juntarAgregados(AgregadoVarredura_t *destino, const AgregadoVarredura_t *origem) {
+    if (origem->numRegistros == 0) {
+        return;
+    }
+    if (destino->numRegistros == 0) {
+        destino->menorChave = origem->menorChave;
+        destino->maiorChave = origem->maiorChave;
+        destino->anoMin = origem->anoMin;
+        destino->anoMax = origem->anoMax;
+    } else {
+        if (origem->menorChave < destino->menorChave) destino->menorChave = origem->menorChave;
+        if (origem->maiorChave > destino->maiorChave) destino->maiorChave = origem->maiorChave;
+        if (origem->anoMin < destino->anoMin) destino->anoMin = origem->anoMin;
+        if (origem->anoMax > destino->anoMax) destino->anoMax = origem->anoMax;
+    }
+    destino->numRegistros += origem->numRegistros;
+
+    for (int i = 0; i < origem->capacidadeGrupos; i++) {
+        const GrupoVarredura_t *parcial = &origem->grupos[i];
+        if (parcial->quantidade == 0) {
+            continue;
+        }
+        int novo;
+        GrupoVarredura_t *grupo = _obterGrupo(destino, parcial->modelo, parcial->cor, &novo);
+        if (novo) {
+            grupo->anoMin = parcial->anoMin;
+            grupo->anoMax = parcial->anoMax;
+        } else {
+            if (parcial->anoMin < grupo->anoMin) grupo->anoMin = parcial->anoMin;
+            if (parcial->anoMax > grupo->anoMax) grupo->anoMax = parcial->anoMax;
+        }
+        grupo->quantidade += parcial->quantidade;
+    }
+}
+
+const GrupoVarredura_t *buscarGrupo(const AgregadoVarredura_t *agregado, const char *modelo, const char *cor) {
+    if (agregado->numGrupos == 0) {
+        return NULL;
+    }
+    GrupoVarredura_t *grupo = _posicaoGrupo(agregado->grupos, agregado->capacidadeGrupos, modelo, cor);
+    return grupo->quantidade != 0 ? grupo : NULL;
+}
+
+// ====================================================================================
+// Divisão da varredura pelos separadores
+// ====================================================================================
+
+static void _adicionarTarefa(PoolVarredura_t *pool, nodo_t *subarvore, unsigned long long inicio, unsigned long long fim) {
+    if (pool->numTarefas == pool->capacidadeTarefas) {
+        pool->capacidadeTarefas = pool->capacidadeTarefas ? 2 * pool->capacidadeTarefas : 64;
+        pool->tarefas = (TarefaVarredura_t *)realloc(pool->tarefas, pool->capacidadeTarefas * sizeof(TarefaVarredura_t));
+        if (pool->tarefas == NULL) {
+            perror("Erro ao alocar tarefas da varredura");
+            exit(EXIT_FAILURE);
+        }
+    }
+    TarefaVarredura_t *tarefa = &pool->tarefas[pool->numTarefas++];
+    tarefa->subarvore = subarvore;
+    tarefa->inicio = inicio;
+    tarefa->fim = fim;
+}
+
+// Desce nível a nível trocando cada subárvore pelas filhas que cruzam [inicio, fim],
+// até ter 'alvo' pedaços ou chegar às folhas. Os limites de cada filha vêm dos
+// separadores do pai, então os pedaços de um nível são disjuntos, em ordem e, como
+// a árvore é balanceada, de tamanhos parecidos.
+static void _particionar(PoolVarredura_t *pool, nodo_t *raiz, unsigned long long inicio, unsigned long long fim, int alvo) {
+    pool->numTarefas = 0;
+    _adicionarTarefa(pool, raiz, inicio, fim);
+    TarefaVarredura_t *nivel = NULL;
+    int capacidadeNivel = 0;
+    while (pool->numTarefas > 0 && pool->numTarefas < alvo && !pool->tarefas[0].subarvore->folha) {
+        int numNivel = pool->numTarefas;
+        if (numNivel > capacidadeNivel) {
+            capacidadeNivel = pool->capacidadeTarefas;
+            nivel = (TarefaVarredura_t *)realloc(nivel, capacidadeNivel * sizeof(TarefaVarredura_t));
+            if (nivel == NULL) {
+                perror("Erro ao alocar tarefas da varredura");
+                exit(EXIT_FAILURE);
+            }
+        }
+        memcpy(nivel, pool->tarefas, numNivel * sizeof(TarefaVarredura_t));
+        pool->numTarefas = 0;
+        for (int t = 0; t < numNivel; t++) {
+            nodo_t *nodo = nivel[t].subarvore;
+            for (int i = 0; i <= nodo->numChaves; i++) {
+                // Filha i guarda as chaves em [chaves[i-1], chaves[i]); recorta pelo pedaço do pai
+                unsigned long long menor = i > 0 && nodo->chaves[i - 1] > nivel[t].inicio ? nodo->chaves[i - 1] : nivel[t].inicio;
+                unsigned long long maior = nivel[t].fim;
+                if (i < nodo->numChaves && nodo->chaves[i] <= maior) {
+                    if (nodo->chaves[i] == 0) {
+                        continue;
+                    }
+                    maior = nodo->chaves[i] - 1;
+                }
+                if (menor <= maior) {
+                    _adicionarTarefa(pool, nodo->filhos[i], menor, maior);
+                }
+            }
+        }
+    }
+    free(nivel);
+}
+
+// Agrega as chaves do pedaço: desce até a folha de 'inicio' e segue o encadeamento
+static void _executarTarefa(const TarefaVarredura_t *tarefa, AgregadoVarredura_t *parcial) {
+    nodo_t *folha = tarefa->subarvore;
+    while (!folha->folha) {
+        int i = 0;
+        while (i < folha->numChaves && tarefa->inicio >= folha->chaves[i]) {
+            i++;
+        }
+        folha = folha->filhos[i];
+    }
+    int i = 0;
+    while (i < folha->numChaves && folha->chaves[i] < tarefa->inicio) {
+        i++;
+    }
+    for (; folha != NULL; folha = folha->proximo, i = 0) {
+        if (folha->proximo != NULL) {
+            __builtin_prefetch(folha->proximo);
+        }
+        for (; i < folha->numChaves; i++) {
+            if (folha->chaves[i] > tarefa->fim) {
+                return;
+            }
+            agregarRegistro(parcial, folha->registros[i]);
+        }
+    }
+}
+
+// ====================================================================================
+// Pool de threads com roubo de tarefas
+// ====================================================================================
+
+// Tarefa seguinte da própria fila ou, se ela acabou, uma roubada do fim da fila de outra thread
+static const TarefaVarredura_t *_proximaTarefa(TrabalhadorVarredura_t *trabalhador) {
+    PoolVarredura_t *pool = trabalhador->pool;
+    const TarefaVarredura_t *tarefa = NULL;
+    pthread_mutex_lock(&trabalhador->trava);
+    if (trabalhador->frente < trabalhador->fim) {
+        tarefa = &pool->tarefas[trabalhador->frente++];
+    }
+    pthread_mutex_unlock(&trabalhador->trava);
+    if (tarefa != NULL) {
+        return tarefa;
+    }
+
+    int id = (int)(trabalhador - pool->trabalhadores);
+    for (int k = 1; k < pool->numThreads && tarefa == NULL; k++) {
+        TrabalhadorVarredura_t *vitima = &pool->trabalhadores[(id + k) % pool->numThreads];
+        pthread_mutex_lock(&vitima->trava);
+        if (vitima->frente < vitima->fim) {
+            tarefa = &pool->tarefas[--vitima->fim];
+        }
+        pthread_mutex_unlock(&vitima->trava);
+    }
+    if (tarefa != NULL) {
+        trabalhador->roubadas++;
+    }
+    return tarefa;
+}
+
+static void *_trabalhadorVarredura(void *arg) {
+    TrabalhadorVarredura_t *trabalhador = (TrabalhadorVarredura_t *)arg;
+    PoolVarredura_t *pool = trabalhador->pool;
+    unsigned long vista = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->trava);
+        while (pool->geracao == vista && !pool->encerrar) {
+            pthread_cond_wait(&pool->inicio, &pool->trava);
+        }
+        if (pool->encerrar) {
+            pthread_mutex_unlock(&pool->trava);
+            return NULL;
+        }
+        vista = pool->geracao;
+        pthread_mutex_unlock(&pool->trava);
+
+        // Nenhuma tarefa nova aparece durante a varredura: filas vazias significam fim
+        const TarefaVarredura_t *tarefa;
+        while ((tarefa = _proximaTarefa(trabalhador)) != NULL) {
+            _executarTarefa(tarefa, &trabalhador->parcial);
+        }
+
+        pthread_mutex_lock(&pool->trava);
+        if (--pool->ativos == 0) {
+            pthread_cond_signal(&pool->termino);
+        }
+        pthread_mutex_unlock(&pool->trava);
+    }
+}
+
+PoolVarredura_t *criarPoolVarredura(int numThreads) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    } else if (numThreads > MAX_THREADS_VARREDURA) {
+        numThreads = MAX_THREADS_VARREDURA;
+    }
+    PoolVarredura_t *pool = (PoolVarredura_t *)aligned_alloc(64, sizeof(PoolVarredura_t));
+    if (pool == NULL) {
+        perror("Erro ao alocar pool de varredura");
+        exit(EXIT_FAILURE);
+    }
+    pool->numThreads = numThreads;
+    pthread_mutex_init(&pool->trava, NULL);
+    pthread_cond_init(&pool->inicio, NULL);
+    pthread_cond_init(&pool->termino, NULL);
+    pool->geracao = 0;
+    pool->ativos = 0;
+    pool->encerrar = 0;
+    pool->tarefas = NULL;
+    pool->numTarefas = 0;
+    pool->capacidadeTarefas = 0;
+    pool->ultimasRoubadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        TrabalhadorVarredura_t *trabalhador = &pool->trabalhadores[t];
+        trabalhador->pool = pool;
+        pthread_mutex_init(&trabalhador->trava, NULL);
+        trabalhador->frente = trabalhador->fim = 0;
+        trabalhador->roubadas = 0;
+        iniciarAgregado(&trabalhador->parcial);
+        if (pthread_create(&trabalhador->thread, NULL, _trabalhadorVarredura, trabalhador) != 0) {
+            perror("Erro ao criar thread de varredura");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return pool;
+}
+
+void destruirPoolVarredura(PoolVarredura_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->trava);
+    pool->encerrar = 1;
+    pthread_cond_broadcast(&pool->inicio);
+    pthread_mutex_unlock(&pool->trava);
+    for (int t = 0; t < pool->numThreads; t++) {
+        TrabalhadorVarredura_t *trabalhador = &pool->trabalhadores[t];
+        pthread_join(trabalhador->thread, NULL);
+        pthread_mutex_destroy(&trabalhador->trava);
+        liberarAgregado(&trabalhador->parcial);
+    }
+    pthread_mutex_destroy(&pool->trava);
+    pthread_cond_destroy(&pool->inicio);
+    pthread_cond_destroy(&pool->termino);
+    free(pool->tarefas);
+    free(pool);
+}
+
+// Cada thread recebe um bloco contíguo de pedaços (folhas vizinhas, boa localidade);
+// quem termina antes rouba do fim do bloco das outras e os parciais são somados no fim
+void varrerParalelo(PoolVarredura_t *pool, BPlusTree_t *arvore, unsigned long long inicio, unsigned long long fim, AgregadoVarredura_t *resultado) {
+    iniciarAgregado(resultado);
+    if (pool == NULL || arvore == NULL || arvore->raiz == NULL || inicio > fim) {
+        return;
+    }
+    _particionar(pool, arvore->raiz, inicio, fim, pool->numThreads * TAREFAS_POR_THREAD);
+    for (int t = 0; t < pool->numThreads; t++) {
+        TrabalhadorVarredura_t *trabalhador = &pool->trabalhadores[t];
+        trabalhador->frente = (int)((long)pool->numTarefas * t / pool->numThreads);
+        trabalhador->fim = (int)((long)pool->numTarefas * (t + 1) / pool->numThreads);
+        trabalhador->roubadas = 0;
+        _limparAgregado(&trabalhador->parcial);
+    }
+
+    pthread_mutex_lock(&pool->trava);
+    pool->ativos = pool->numThreads;
+    pool->geracao++;
+    pthread_cond_broadcast(&pool->inicio);
+    while (pool->ativos > 0) {
+        pthread_cond_wait(&pool->termino, &pool->trava);
+    }
+    pthread_mutex_unlock(&pool->trava);
+
+    pool->ultimasRoubadas = 0;
+    for (int t = 0; t < pool->numThreads; t++) {
+        juntarAgregados(resultado, &pool->trabalhadores[t].parcial);
+        pool->ultimasRoubadas += pool->trabalhadores[t].roubadas;
+    }
+}
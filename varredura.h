@@ -0,0 +1,77 @@
+#ifndef VARREDURA_H
+#define VARREDURA_H
+
+#include <pthread.h>
+#include "BPlusTree.h"
+
+#define MAX_THREADS_VARREDURA 64
+#define TAREFAS_POR_THREAD 8 //pedaços por thread: sobra trabalho para roubar quando um pedaço demora mais
+
+//totais de um par (modelo, cor)
+typedef struct {
+    char modelo[TAM_MODELO]; //modelo do veículo
+    char cor[TAM_COR]; //cor do veículo
+    long quantidade; //registros do grupo (0 = posição livre na tabela)
+    int anoMin; //ano de fabricação mais antigo do grupo
+    int anoMax; //ano de fabricação mais recente do grupo
+} GrupoVarredura_t;
+
+//resultado de uma varredura: totais gerais e agrupamento por modelo e cor
+typedef struct {
+    long numRegistros; //registros visitados
+    unsigned long long menorChave; //menor renavam (válido se numRegistros > 0)
+    unsigned long long maiorChave; //maior renavam (válido se numRegistros > 0)
+    int anoMin; //ano mais antigo
+    int anoMax; //ano mais recente
+    GrupoVarredura_t *grupos; //tabela de espalhamento aberta, indexada por (modelo, cor)
+    int capacidadeGrupos; //tamanho da tabela (potência de 2)
+    int numGrupos; //grupos ocupados
+} AgregadoVarredura_t;
+
+//pedaço da varredura: as chaves em [inicio, fim] de uma subárvore delimitada por separadores
+typedef struct {
+    nodo_t *subarvore; //subárvore que contém todas as chaves do pedaço
+    unsigned long long inicio; //menor chave do pedaço
+    unsigned long long fim; //maior chave do pedaço
+} TarefaVarredura_t;
+
+struct PoolVarredura;
+
+//thread do pool com a sua fila de tarefas: a dona consome pela frente, as outras roubam do fim
+typedef struct {
+    struct PoolVarredura *pool; //pool ao qual a thread pertence
+    pthread_t thread; //thread trabalhadora
+    pthread_mutex_t trava; //protege frente e fim
+    int frente; //próxima tarefa da dona (índice em pool->tarefas)
+    int fim; //uma posição após a última tarefa ainda não executada
+    long roubadas; //tarefas que esta thread tirou de outras na varredura atual
+    _Alignas(64) AgregadoVarredura_t parcial; //resultado parcial da thread (linha de cache própria)
+} TrabalhadorVarredura_t;
+
+//pool de threads reaproveitado entre varreduras
+typedef struct PoolVarredura {
+    TrabalhadorVarredura_t trabalhadores[MAX_THREADS_VARREDURA];
+    int numThreads; //threads ativas
+    pthread_mutex_t trava; //protege geracao, ativos e encerrar
+    pthread_cond_t inicio; //sinaliza uma nova varredura (ou o encerramento)
+    pthread_cond_t termino; //sinaliza que a última thread terminou
+    unsigned long geracao; //incrementada a cada varredura
+    int ativos; //threads que ainda não terminaram a varredura atual
+    int encerrar; //1 quando o pool está sendo destruído
+    TarefaVarredura_t *tarefas; //pedaços da varredura atual
+    int numTarefas; //pedaços gerados
+    int capacidadeTarefas; //tamanho do vetor de pedaços
+    long ultimasRoubadas; //tarefas roubadas na última varredura
+} PoolVarredura_t;
+
+PoolVarredura_t *criarPoolVarredura(int numThreads); //cria as threads, que ficam esperando varreduras
+void destruirPoolVarredura(PoolVarredura_t *pool); //encerra as threads e libera o pool
+void varrerParalelo(PoolVarredura_t *pool, BPlusTree_t *arvore, unsigned long long inicio, unsigned long long fim, AgregadoVarredura_t *resultado); //agrega as chaves em [inicio, fim]; a árvore não pode mudar durante a varredura
+
+void iniciarAgregado(AgregadoVarredura_t *agregado); //deixa o agregado vazio (sem alocar)
+void liberarAgregado(AgregadoVarredura_t *agregado); //libera a tabela de grupos
+void agregarRegistro(AgregadoVarredura_t *agregado, const registro_t *registro); //soma um registro ao agregado
+void juntarAgregados(AgregadoVarredura_t *destino, const AgregadoVarredura_t *origem); //soma 'origem' em 'destino'
+const GrupoVarredura_t *buscarGrupo(const AgregadoVarredura_t *agregado, const char *modelo, const char *cor); //NULL se o par não apareceu
+
+#endif // VARREDURA_H